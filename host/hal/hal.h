@@ -0,0 +1,104 @@
+#pragma once
+// Simulator-facing side of the host HAL. The firmware only sees the Arduino,
+// FreeRTOS, LittleFS and Firebase headers in host/include; the simulator uses
+// this header to drive the virtual clock, plug in sensor models, break the
+// network and inspect what the device published.
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace hal {
+
+// ====== VIRTUAL CLOCK ======
+// Time only moves inside delay()/vTaskDelay()/pulseIn() or when the
+// simulator advances it. Wall-clock time is readable once the simulated
+// SNTP client answered configTime(); it survives ESP.restart() like the RTC.
+uint64_t nowUs();
+void advanceUs(uint64_t us);
+void setWallClock(time_t epochAtZero);   // epoch at virtual t = 0
+bool wallClockSynced();
+// An idle wait (ulTaskNotifyTake) jumps straight to its timeout, the next
+// UART reply or the simulator's next scripted event, whichever comes first.
+// On the event it returns early so the simulator can run it.
+void setNextEventSource(std::function<uint64_t()> nextEventUs);
+
+// ====== DEVICES ======
+// Callbacks the simulator provides; unset ones read as "not connected".
+struct Devices {
+  std::function<uint16_t(uint8_t pin)> analog;                 // 12-bit ADC
+  // Offset added to each DMA conversion (n counts from adc_digi_start());
+  // unset = the built-in ±60 LSB triangular noise with rare ±300 spikes
+  std::function<int(uint64_t n)> adcNoise;
+  std::function<unsigned long(uint8_t pin)> echoUs;            // echo width, 0 = no echo
+  std::function<float()> lux;                                  // BH1750
+  std::function<bool(int uart, uint16_t address, uint16_t count, uint16_t* out)> holdingRegisters;
+  std::function<void(uint8_t pin, uint8_t level)> pinChanged;
+  unsigned modbusLatencyMs = 40;   // request → reply, 4800 baud + sensor turnaround
+  // Ultrasonic ranger: the trigger's falling edge raises echoPin after
+  // echoDelayUs for echoUs(echoPin), with pin interrupts at both edges
+  int echoTrigPin = -1;
+  int echoPin = -1;
+  unsigned echoDelayUs = 450;
+};
+Devices& devices();
+int pinLevel(uint8_t pin);
+
+// ====== NETWORK ======
+struct Network {
+  bool wifiUp = true;
+  bool backendUp = true;
+  int rssi = -62;
+  unsigned failureCostMs = 0;   // extra time a failed RTDB call blocks for
+  unsigned roundTripMs = 60;    // every RTDB request on a live link waits this long
+};
+Network& network();
+
+struct RtdbStats {
+  uint64_t requests = 0;     // every RTDB call that reached the mock
+  uint64_t failures = 0;
+  uint64_t writes = 0;       // set*/update/delete
+  uint64_t reads = 0;
+  uint64_t bytesUp = 0;      // payload bytes the device sent
+  uint64_t bytesDown = 0;    // response payloads, update echoes included
+  uint64_t handshakes = 0;   // full TLS handshakes, streams included
+  uint64_t handshakeBytes = 0;
+  uint64_t streamEvents = 0;
+};
+RtdbStats& rtdbStats();
+
+// App-side access to the database ("/devices/X/commands/mode" etc.).
+// Values are JSON text; writes fire the device's stream callbacks.
+void rtdbPut(const std::string& path, const std::string& json);
+void rtdbDelete(const std::string& path);
+bool rtdbGet(const std::string& path, std::string& json);
+size_t rtdbCount(const std::string& prefix);      // leaves under prefix
+size_t rtdbChildren(const std::string& path);     // direct child keys
+
+// ====== FILESYSTEM ======
+size_t fsUsedBytes();
+size_t fsFileCount(const std::string& prefix);
+
+// ====== HEAP AUDIT ======
+// Counts operator new calls made by firmware code while armed. Work inside
+// the simulated libraries (RTDB client, LittleFS, UART slaves, stream
+// delivery) is not charged: on the device that happens in library internals
+// the firmware cannot preallocate for.
+struct AllocStats {
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+};
+void setAllocAudit(bool armed);
+AllocStats allocStats();
+
+// ====== SERIAL / RESTART ======
+void setSerialEcho(bool echo);
+uint64_t serialBytes();
+
+// Thrown by ESP.restart(); the simulator catches it and calls setup() again.
+struct Restart {};
+unsigned restartCount();
+
+}  // namespace hal
@@ -0,0 +1,66 @@
+// Heap audit for the host build: global operator new counts every
+// allocation the firmware makes while the audit is armed, and prints a
+// backtrace for the first few so they can be traced with addr2line.
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "hal_internal.h"
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define HAL_HAVE_BACKTRACE 1
+#endif
+
+namespace {
+
+bool armed = false;
+int libraryDepth = 0;
+hal::AllocStats stats;
+
+const unsigned REPORTED_ALLOCATIONS = 3;
+
+void report(size_t size) {
+  fprintf(stderr, "heap audit: firmware allocated %zu bytes after warm-up\n", size);
+#ifdef HAL_HAVE_BACKTRACE
+  void* frames[24];
+  int n = backtrace(frames, 24);
+  backtrace_symbols_fd(frames, n, 2);
+#endif
+}
+
+void* allocate(size_t size) {
+  if (armed && libraryDepth == 0) {
+    stats.allocations++;
+    stats.bytes += size;
+    if (stats.allocations <= REPORTED_ALLOCATIONS) {
+      libraryDepth++;   // backtrace() may allocate on first use
+      report(size);
+      libraryDepth--;
+    }
+  }
+  return malloc(size ? size : 1);
+}
+
+}  // namespace
+
+namespace hal {
+
+void setAllocAudit(bool on) { armed = on; }
+AllocStats allocStats() { return stats; }
+
+LibraryCall::LibraryCall() { libraryDepth++; }
+LibraryCall::~LibraryCall() { libraryDepth--; }
+
+}  // namespace hal
+
+void* operator new(size_t size) {
+  void* p = allocate(size);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
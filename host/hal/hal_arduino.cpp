@@ -0,0 +1,474 @@
+// GPIO and pin interrupts, ADC, ultrasonic echo, UART/Modbus slaves, BH1750
+// and WiFi for the host build. Sensor values come from the callbacks in
+// hal::devices().
+#include <Arduino.h>
+#include <BH1750.h>
+#include <driver/adc.h>
+#include <WiFiManager.h>
+#include <deque>
+#include <vector>
+#include "hal_internal.h"
+
+namespace {
+
+int pinLevels[64] = {};
+bool serialEcho = false;
+uint64_t serialByteCount = 0;
+
+struct PendingReply {
+  HardwareSerial* port;
+  uint64_t dueUs;
+  std::vector<uint8_t> bytes;
+};
+std::deque<PendingReply> pendingReplies;
+std::deque<uint8_t> rxBuffers[3];
+
+struct PendingEdge {
+  uint64_t atUs;
+  uint8_t pin;
+  uint8_t level;
+};
+std::deque<PendingEdge> pendingEdges;   // in time order
+void (*pinIsr[64])() = {};
+int pinIsrMode[64] = {};
+
+uint16_t crc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+  }
+  return crc;
+}
+
+}  // namespace
+
+namespace hal {
+
+Devices& devices() {
+  static Devices d;
+  return d;
+}
+
+int pinLevel(uint8_t pin) { return pin < 64 ? pinLevels[pin] : 0; }
+
+void setSerialEcho(bool echo) { serialEcho = echo; }
+uint64_t serialBytes() { return serialByteCount; }
+
+namespace detail {
+
+// Replies land in the RX buffer and raise the onReceive event, like the
+// ESP32 UART driver does after the RX timeout.
+uint64_t nextUartReplyUs() {
+  return pendingReplies.empty() ? UINT64_MAX : pendingReplies.front().dueUs;
+}
+
+void serviceUart() {
+  LibraryCall lib;
+  while (!pendingReplies.empty() && pendingReplies.front().dueUs <= nowUs()) {
+    PendingReply reply = std::move(pendingReplies.front());
+    pendingReplies.pop_front();
+    std::deque<uint8_t>& rx = rxBuffers[reply.port->uart_];
+    rx.insert(rx.end(), reply.bytes.begin(), reply.bytes.end());
+    if (reply.port->onReceive_) reply.port->onReceive_();
+  }
+}
+
+uint64_t nextGpioEdgeUs() {
+  return pendingEdges.empty() ? UINT64_MAX : pendingEdges.front().atUs;
+}
+
+void serviceGpio() {
+  while (!pendingEdges.empty() && pendingEdges.front().atUs <= nowUs()) {
+    PendingEdge edge = pendingEdges.front();
+    pendingEdges.pop_front();
+    if (pinLevels[edge.pin] == edge.level) continue;
+    pinLevels[edge.pin] = edge.level;
+    int mode = pinIsrMode[edge.pin];
+    bool fire = mode == CHANGE || (mode == RISING && edge.level) || (mode == FALLING && !edge.level);
+    if (pinIsr[edge.pin] && fire) pinIsr[edge.pin]();
+  }
+}
+
+}  // namespace detail
+}  // namespace hal
+
+// ====== SERIAL ======
+HardwareSerial Serial(0);
+
+// Same shape as the ESP32 core: a 64-byte stack buffer, heap beyond that.
+// The heap path is charged to the caller by the allocation audit.
+size_t Print::printf(const char* fmt, ...) {
+  char buf[64];
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  if (n < 0) return 0;
+  if ((size_t)n < sizeof(buf)) return write((const uint8_t*)buf, n);
+
+  char* big = new char[n + 1];
+  va_start(args, fmt);
+  vsnprintf(big, n + 1, fmt, args);
+  va_end(args);
+  size_t written = write((const uint8_t*)big, n);
+  delete[] big;
+  return written;
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t, int, int) { baud_ = baud; }
+
+int HardwareSerial::available() { return (int)rxBuffers[uart_].size(); }
+
+int HardwareSerial::read() {
+  std::deque<uint8_t>& rx = rxBuffers[uart_];
+  if (rx.empty()) return -1;
+  int b = rx.front();
+  rx.pop_front();
+  return b;
+}
+
+// UART0 is the console; UART1/2 have a Modbus RTU slave on the other end
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+  if (uart_ == 0) {
+    serialByteCount += n;
+    if (serialEcho) fwrite(buf, 1, n, stdout);
+    return n;
+  }
+
+  hal::LibraryCall lib;
+  hal::Devices& dev = hal::devices();
+  if (n != 8 || buf[1] != 0x03 || !dev.holdingRegisters) return n;
+  if (crc16(buf, 6) != (buf[6] | (buf[7] << 8))) return n;
+
+  uint16_t address = (buf[2] << 8) | buf[3];
+  uint16_t count = (buf[4] << 8) | buf[5];
+  uint16_t regs[32];
+  if (count == 0 || count > 32 || !dev.holdingRegisters(uart_, address, count, regs)) {
+    return n;  // sensor absent → master times out
+  }
+
+  PendingReply reply;
+  reply.port = this;
+  reply.dueUs = hal::nowUs() + (uint64_t)dev.modbusLatencyMs * 1000;
+  reply.bytes.push_back(buf[0]);
+  reply.bytes.push_back(0x03);
+  reply.bytes.push_back((uint8_t)(count * 2));
+  for (uint16_t i = 0; i < count; i++) {
+    reply.bytes.push_back(regs[i] >> 8);
+    reply.bytes.push_back(regs[i] & 0xFF);
+  }
+  uint16_t crc = crc16(reply.bytes.data(), reply.bytes.size());
+  reply.bytes.push_back(crc & 0xFF);
+  reply.bytes.push_back(crc >> 8);
+  pendingReplies.push_back(std::move(reply));
+  return n;
+}
+
+// ====== GPIO / ADC ======
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  if (pin >= 64 || pinLevels[pin] == level) return;
+  hal::LibraryCall lib;
+  pinLevels[pin] = level;
+  hal::Devices& dev = hal::devices();
+  if (dev.pinChanged) dev.pinChanged(pin, level);
+
+  // End of the trigger pulse: schedule the echo, none if nothing answers
+  if (pin == dev.echoTrigPin && level == LOW && dev.echoPin >= 0 && dev.echoUs) {
+    unsigned long width = dev.echoUs((uint8_t)dev.echoPin);
+    if (width > 0) {
+      uint64_t rise = hal::nowUs() + dev.echoDelayUs;
+      pendingEdges.push_back({rise, (uint8_t)dev.echoPin, HIGH});
+      pendingEdges.push_back({rise + width, (uint8_t)dev.echoPin, LOW});
+    }
+  }
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+  if (pin >= 64) return;
+  pinIsr[pin] = isr;
+  pinIsrMode[pin] = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin < 64) pinIsr[pin] = nullptr;
+}
+
+int digitalRead(uint8_t pin) { return hal::pinLevel(pin); }
+
+uint16_t analogRead(uint8_t pin) {
+  hal::LibraryCall lib;
+  return hal::devices().analog ? hal::devices().analog(pin) : 0;
+}
+
+void analogSetPinAttenuation(uint8_t, int) {}
+
+// ====== ADC CONTINUOUS MODE ======
+namespace {
+
+const uint8_t ADC1_GPIO[8] = {36, 37, 38, 39, 32, 33, 34, 35};
+const uint32_t ADC_LEVEL_EVERY = 64;   // conversions per sensor model query
+
+struct AdcDma {
+  bool initialized = false;
+  bool running = false;
+  uint8_t channel = 0;
+  uint32_t rateHz = 20000;
+  size_t ringWords = 0;
+  uint64_t startUs = 0;
+  uint64_t converted = 0;
+  uint16_t level = 0;
+  std::deque<uint16_t> ring;
+} adcDma;
+
+int adcNoise() {
+  uint32_t r = hal::detail::nextRandom();
+  int n = (int)(r % 61) + (int)((r >> 8) % 61) - 60;   // triangular, σ ≈ 25 LSB
+  if ((r >> 20) % 512 == 0) n += ((r >> 16) & 1) ? 300 : -300;
+  return n;
+}
+
+// Conversions due since start, oldest dropped once the ring is full
+void adcCatchUp() {
+  uint64_t due = (hal::nowUs() - adcDma.startUs) * adcDma.rateHz / 1000000;
+  hal::Devices& dev = hal::devices();
+  for (; adcDma.converted < due; adcDma.converted++) {
+    if (adcDma.converted % ADC_LEVEL_EVERY == 0) {
+      adcDma.level = dev.analog ? dev.analog(ADC1_GPIO[adcDma.channel]) : 0;
+    }
+    int noise = dev.adcNoise ? dev.adcNoise(adcDma.converted) : adcNoise();
+    int v = adcDma.level ? std::min(4095, std::max(0, adcDma.level + noise)) : 0;
+    adc_digi_output_data_t word;
+    word.type1.data = (uint16_t)v;
+    word.type1.channel = adcDma.channel;
+    if (adcDma.ring.size() == adcDma.ringWords) adcDma.ring.pop_front();
+    adcDma.ring.push_back(word.val);
+  }
+}
+
+}  // namespace
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* config) {
+  adcDma.ringWords = config->max_store_buf_size / sizeof(uint16_t);
+  adcDma.initialized = true;
+  return ESP_OK;
+}
+
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config) {
+  if (!adcDma.initialized || config->pattern_num < 1) return ESP_ERR_INVALID_STATE;
+  adcDma.channel = config->adc_pattern[0].channel;
+  adcDma.rateHz = config->sample_freq_hz;
+  return ESP_OK;
+}
+
+esp_err_t adc_digi_start() {
+  if (!adcDma.initialized) return ESP_ERR_INVALID_STATE;
+  adcDma.running = true;
+  adcDma.startUs = hal::nowUs();
+  adcDma.converted = 0;
+  return ESP_OK;
+}
+
+esp_err_t adc_digi_stop() {
+  if (adcDma.running) {
+    hal::LibraryCall lib;
+    adcCatchUp();
+  }
+  adcDma.running = false;
+  return ESP_OK;
+}
+
+esp_err_t adc_digi_read_bytes(uint8_t* buf, uint32_t maxLength, uint32_t* outLength, uint32_t) {
+  hal::LibraryCall lib;
+  if (adcDma.running) adcCatchUp();
+  uint32_t n = 0;
+  while (n + 2 <= maxLength && !adcDma.ring.empty()) {
+    uint16_t word = adcDma.ring.front();
+    adcDma.ring.pop_front();
+    memcpy(buf + n, &word, 2);
+    n += 2;
+  }
+  *outLength = n;
+  return n > 0 ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t adc_digi_deinitialize() {
+  adcDma = AdcDma();
+  return ESP_OK;
+}
+
+// Blocks for the echo width (or the timeout), as the real pulseIn does
+unsigned long pulseIn(uint8_t pin, uint8_t, unsigned long timeout) {
+  hal::LibraryCall lib;
+  unsigned long width = hal::devices().echoUs ? hal::devices().echoUs(pin) : 0;
+  if (width == 0 || width > timeout) {
+    hal::advanceUs(timeout);
+    return 0;
+  }
+  hal::advanceUs(width);
+  return width;
+}
+
+// ====== I2C / BH1750 ======
+TwoWire Wire;
+
+bool BH1750::begin(Mode, uint8_t, TwoWire*) {
+  hal::LibraryCall lib;
+  started_ = (bool)hal::devices().lux;
+  return started_;
+}
+
+float BH1750::readLightLevel() {
+  hal::LibraryCall lib;
+  if (!started_ || !hal::devices().lux) return -2;  // library's "not configured"
+  return hal::devices().lux();
+}
+
+// ====== WIFI ======
+WiFiClass WiFi;
+
+namespace {
+const char* const SIM_SSID = "AgriLeafy-Sim";
+const uint64_t WIFI_JOIN_US = 1500000;        // scan, auth, DHCP
+const uint64_t WIFI_JOIN_FAIL_US = 4000000;   // scan finds no AP
+
+enum StaState { STA_IDLE, STA_JOINING, STA_CONNECTED };
+StaState sta = STA_IDLE;
+uint64_t joinDoneUs = 0;
+bool autoReconnect = true;
+std::string staSsid = SIM_SSID;   // the saved network
+struct EventHandler {
+  WiFiEventFuncCb callback;
+  arduino_event_id_t event;
+};
+std::vector<EventHandler> eventHandlers;
+
+void emit(arduino_event_id_t event, uint8_t reason = 0) {
+  arduino_event_info_t info = {};
+  if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+    size_t n = std::min(staSsid.size(), sizeof(info.wifi_sta_disconnected.ssid));
+    memcpy(info.wifi_sta_disconnected.ssid, staSsid.data(), n);
+    info.wifi_sta_disconnected.ssid_len = (uint8_t)n;
+    info.wifi_sta_disconnected.reason = reason;
+  }
+  for (const EventHandler& h : eventHandlers) {
+    if (h.event == ARDUINO_EVENT_MAX || h.event == event) h.callback(event, info);
+  }
+}
+
+void startJoin() {
+  sta = STA_JOINING;
+  joinDoneUs = hal::nowUs() + (hal::network().wifiUp ? WIFI_JOIN_US : WIFI_JOIN_FAIL_US);
+}
+}  // namespace
+
+namespace hal {
+namespace detail {
+
+bool stationUp() { return sta == STA_CONNECTED && network().wifiUp; }
+
+void resetWiFi() {
+  sta = STA_IDLE;
+  autoReconnect = true;
+  eventHandlers.clear();
+}
+
+uint64_t nextWiFiUs() { return sta == STA_JOINING ? joinDoneUs : UINT64_MAX; }
+
+// Loses the AP when the simulator takes WiFi down and finishes joins; with
+// auto-reconnect on, the driver keeps retrying by itself like the core does
+void serviceWiFi() {
+  if (sta == STA_CONNECTED && !network().wifiUp) {
+    sta = STA_IDLE;
+    emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_BEACON_TIMEOUT);
+    if (autoReconnect && sta == STA_IDLE) startJoin();
+  }
+  if (sta == STA_JOINING && nowUs() >= joinDoneUs) {
+    if (network().wifiUp && staSsid == SIM_SSID) {
+      sta = STA_CONNECTED;
+      emit(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+      emit(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    } else {
+      sta = STA_IDLE;
+      emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_NO_AP_FOUND);
+      if (autoReconnect && sta == STA_IDLE) startJoin();
+    }
+  }
+}
+
+}  // namespace detail
+}  // namespace hal
+
+int WiFiClass::status() { return hal::detail::stationUp() ? WL_CONNECTED : WL_DISCONNECTED; }
+
+int WiFiClass::begin() {
+  if (sta != STA_CONNECTED) startJoin();
+  return WL_DISCONNECTED;
+}
+
+int WiFiClass::begin(const char* ssid, const char*) {
+  if (sta == STA_CONNECTED && staSsid == ssid) return WL_CONNECTED;
+  if (sta == STA_CONNECTED) disconnect();
+  staSsid = ssid;
+  startJoin();
+  return WL_DISCONNECTED;
+}
+
+String WiFiClass::SSID() { return staSsid.c_str(); }
+String WiFiClass::psk() { return "sim-passphrase"; }
+IPAddress WiFiClass::localIP() { return status() == WL_CONNECTED ? IPAddress(192, 168, 1, 50) : IPAddress(); }
+int WiFiClass::RSSI() { return status() == WL_CONNECTED ? hal::network().rssi : 0; }
+
+bool WiFiClass::reconnect() {
+  if (sta == STA_CONNECTED) disconnect();
+  startJoin();
+  return true;
+}
+
+bool WiFiClass::disconnect(bool) {
+  bool was = sta == STA_CONNECTED;
+  sta = STA_IDLE;
+  if (was) emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_ASSOC_LEAVE);
+  return true;
+}
+
+bool WiFiClass::setAutoReconnect(bool on) {
+  autoReconnect = on;
+  return true;
+}
+
+bool WiFiClass::getAutoReconnect() { return autoReconnect; }
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventFuncCb callback, arduino_event_id_t event) {
+  eventHandlers.push_back({callback, event});
+  return (wifi_event_id_t)eventHandlers.size();
+}
+
+// Blocks for the connect timeout, then the portal timeout, when the AP is gone
+bool WiFiManager::autoConnect(const char*, const char*) {
+  hal::LibraryCall lib;
+  if (hal::network().wifiUp) {
+    delay(1500);
+    return true;
+  }
+  delay((unsigned long)(connectTimeout_ + portalTimeout_) * 1000);
+  return hal::network().wifiUp;
+}
+
+// Non-blocking portal: the station keeps retrying the saved network meanwhile
+bool WiFiManager::startConfigPortal(const char*, const char*) {
+  hal::LibraryCall lib;
+  if (blocking_) {
+    delay((unsigned long)portalTimeout_ * 1000);
+    return WiFi.status() == WL_CONNECTED;
+  }
+  portalOpen_ = true;
+  return false;
+}
+
+bool WiFiManager::process() {
+  if (portalOpen_ && WiFi.status() == WL_CONNECTED) portalOpen_ = false;
+  return WiFi.status() == WL_CONNECTED;
+}
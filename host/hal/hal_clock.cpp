@@ -0,0 +1,332 @@
+// Virtual clock, esp_timer, SNTP, FreeRTOS and ESP system calls for the host build.
+#include <Arduino.h>
+#include <esp_sntp.h>
+#include <esp_task_wdt.h>
+#include <esp_timer.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include "hal_internal.h"
+
+struct esp_timer {
+  esp_timer_cb_t callback;
+  void* arg;
+  uint64_t dueUs;
+  bool armed;
+};
+
+namespace {
+
+uint64_t clockUs = 0;
+time_t wallAtZero = 1748707200;   // 2025-06-01 00:00 PHT
+bool sntpStarted = false;
+bool sntpSynced = false;
+uint64_t sntpDueUs = 0;        // next answer: first sync, then hourly
+sntp_sync_time_cb_t sntpCallback = nullptr;
+long tzOffsetSec = 0;
+unsigned restarts = 0;
+uint32_t rngState = 0x9E3779B9u;
+std::function<uint64_t()> nextEventSource;
+uint32_t notifications = 0;
+std::vector<esp_timer*> timers;
+uint64_t wdtTimeoutUs = 0;
+bool wdtWatching = false;
+uint64_t wdtFedUs = 0;
+
+const uint64_t SNTP_ROUND_TRIP_US = 1200000;
+const uint64_t SNTP_UPDATE_US = 3600000000ULL;
+
+// An answer that falls due while WiFi is down arrives once it is back
+void pollSntp() {
+  if (!sntpStarted || clockUs < sntpDueUs || !hal::network().wifiUp) return;
+  sntpSynced = true;
+  sntpDueUs = clockUs + SNTP_UPDATE_US;
+  if (sntpCallback) {
+    struct timeval tv;
+    tv.tv_sec = wallAtZero + (time_t)(clockUs / 1000000);
+    tv.tv_usec = (suseconds_t)(clockUs % 1000000);
+    sntpCallback(&tv);
+  }
+}
+
+uint64_t nextTimerUs() {
+  uint64_t next = UINT64_MAX;
+  for (esp_timer* t : timers) {
+    if (t->armed && t->dueUs < next) next = t->dueUs;
+  }
+  return next;
+}
+
+// Callbacks may re-arm or stop timers, so look up the next due one each time
+void serviceTimers() {
+  for (;;) {
+    esp_timer* due = nullptr;
+    for (esp_timer* t : timers) {
+      if (t->armed && t->dueUs <= clockUs && (!due || t->dueUs < due->dueUs)) due = t;
+    }
+    if (!due) return;
+    due->armed = false;
+    due->callback(due->arg);
+  }
+}
+
+void checkWatchdog() {
+  if (!wdtWatching || wdtTimeoutUs == 0 || clockUs - wdtFedUs <= wdtTimeoutUs) return;
+  fflush(stdout);
+  fprintf(stderr, "task watchdog: not fed for %.1f s at t=%.1f s\n", (clockUs - wdtFedUs) / 1e6, clockUs / 1e6);
+  abort();
+}
+
+}  // namespace
+
+namespace hal {
+
+uint64_t nowUs() { return clockUs; }
+
+// Input edges and esp_timer callbacks run at their exact time so they see
+// the right micros()
+void advanceUs(uint64_t us) {
+  LibraryCall lib;
+  uint64_t target = clockUs + us;
+  for (uint64_t next; (next = std::min(detail::nextGpioEdgeUs(), nextTimerUs())) <= target;) {
+    if (next > clockUs) clockUs = next;
+    detail::serviceGpio();
+    serviceTimers();
+  }
+  clockUs = target;
+  checkWatchdog();
+  detail::serviceWiFi();
+  pollSntp();
+  detail::serviceUart();
+  detail::serviceStreams();
+}
+
+void setWallClock(time_t epochAtZero) { wallAtZero = epochAtZero; }
+
+void setNextEventSource(std::function<uint64_t()> nextEventUs) { nextEventSource = std::move(nextEventUs); }
+
+bool wallClockSynced() { return sntpSynced; }
+
+unsigned restartCount() { return restarts; }
+
+namespace detail {
+
+uint64_t nextSntpUs() {
+  return sntpStarted && sntpDueUs > clockUs ? sntpDueUs : UINT64_MAX;
+}
+
+uint32_t nextRandom() {
+  // xorshift32: reproducible runs without touching libc rand()
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+}  // namespace detail
+}  // namespace hal
+
+// ====== ARDUINO TIMING ======
+unsigned long millis() { return (unsigned long)(clockUs / 1000); }
+unsigned long micros() { return (unsigned long)clockUs; }
+int64_t esp_timer_get_time() { return (int64_t)clockUs; }
+void delay(unsigned long ms) { hal::advanceUs((uint64_t)ms * 1000); }
+void delayMicroseconds(unsigned int us) { hal::advanceUs(us); }
+void yield() {}
+
+// ====== ESP_TIMER ======
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+  esp_timer* t = new esp_timer{args->callback, args->arg, 0, false};
+  timers.push_back(t);
+  *out = t;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeoutUs) {
+  if (t->armed) return ESP_ERR_INVALID_STATE;
+  t->dueUs = clockUs + timeoutUs;
+  t->armed = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+  if (!t->armed) return ESP_ERR_INVALID_STATE;
+  t->armed = false;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t t) {
+  timers.erase(std::remove(timers.begin(), timers.end(), t), timers.end());
+  delete t;
+  return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t t) { return t->armed; }
+
+long random(long max) { return max > 0 ? (long)(hal::detail::nextRandom() % (uint32_t)max) : 0; }
+long random(long min, long max) { return max > min ? min + random(max - min) : min; }
+uint32_t esp_random() { return hal::detail::nextRandom(); }
+
+// ====== WALL CLOCK ======
+// Before SNTP answers, time() counts seconds since boot like the ESP32 does.
+extern "C" time_t time(time_t* out) noexcept {
+  time_t now = hal::wallClockSynced() ? wallAtZero + (time_t)(clockUs / 1000000)
+                                      : (time_t)(clockUs / 1000000);
+  if (out) *out = now;
+  return now;
+}
+
+// Restarts the client: the next answer is one round trip away
+void configTime(long gmtOffset, int daylightOffset, const char*, const char*, const char*) {
+  tzOffsetSec = gmtOffset + daylightOffset;
+  sntpStarted = true;
+  sntpDueUs = clockUs + SNTP_ROUND_TRIP_US;
+}
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) { sntpCallback = callback; }
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+  uint32_t waited = 0;
+  while (!hal::wallClockSynced()) {
+    if (waited >= ms) return false;
+    delay(10);
+    waited += 10;
+  }
+  time_t local = time(nullptr) + tzOffsetSec;
+  gmtime_r(&local, info);
+  return true;
+}
+
+// ====== ESP ======
+EspClass ESP;
+
+uint32_t EspClass::getFreeHeap() { return 182000; }
+uint32_t EspClass::getMaxAllocHeap() { return 110000; }
+uint32_t EspClass::getMinFreeHeap() { return 176000; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(clockUs * 240); }
+
+// Timers and the WiFi station do not survive a reset; timer handles stay
+// valid for the next setup()
+void EspClass::restart() {
+  restarts++;
+  for (esp_timer* t : timers) t->armed = false;
+  hal::detail::resetWiFi();
+  throw hal::Restart();
+}
+
+#ifdef HOST_NEEDS_STRLCPY
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t len = strlen(src);
+  if (size > 0) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+#endif
+
+// ====== FREERTOS ======
+struct QueueShim {
+  std::vector<uint8_t> storage;
+  size_t itemSize, capacity, head, count;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  QueueShim* q = new QueueShim();
+  q->storage.resize((size_t)length * itemSize);
+  q->itemSize = itemSize;
+  q->capacity = length;
+  q->head = 0;
+  q->count = 0;
+  return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t) {
+  if (q->count == q->capacity) return pdFALSE;
+  size_t slot = (q->head + q->count) % q->capacity;
+  memcpy(&q->storage[slot * q->itemSize], item, q->itemSize);
+  q->count++;
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t) {
+  if (q->count == 0) return pdFALSE;
+  memcpy(item, &q->storage[q->head * q->itemSize], q->itemSize);
+  q->head = (q->head + 1) % q->capacity;
+  q->count--;
+  return pdTRUE;
+}
+
+// There is no scheduler on the host: the firmware is built with
+// AGRI_SINGLE_TASK and drives both steps from loop().
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char* name, uint32_t, void*, UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+  fprintf(stderr, "host: xTaskCreatePinnedToCore(%s) is not supported, build with AGRI_SINGLE_TASK\n", name);
+  if (handle) *handle = nullptr;
+  return 0;
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+
+void vTaskDelayUntil(TickType_t* last, TickType_t period) {
+  TickType_t target = *last + period;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(target - now) > 0) delay(target - now);
+  *last = target;
+}
+
+void vTaskDelete(TaskHandle_t) {}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) { return (UBaseType_t)q->count; }
+
+// ====== TASK NOTIFICATIONS ======
+struct TaskShim {};
+static TaskShim loopTask;
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return &loopTask; }
+
+BaseType_t xTaskNotifyGive(TaskHandle_t) {
+  notifications++;
+  return pdPASS;
+}
+
+// Tickless: nothing runs while the task waits, so time jumps from one
+// possible wake source to the next instead of stepping through ticks.
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+  uint64_t deadline = ticks == portMAX_DELAY ? UINT64_MAX : clockUs + (uint64_t)ticks * 1000;
+  while (notifications == 0 && clockUs < deadline) {
+    uint64_t scripted = nextEventSource ? nextEventSource() : UINT64_MAX;
+    uint64_t wake = std::min({deadline, scripted, hal::detail::nextUartReplyUs(), hal::detail::nextSntpUs(),
+                               hal::detail::nextGpioEdgeUs(), nextTimerUs(), hal::detail::nextWiFiUs()});
+    if (wake > clockUs) hal::advanceUs(wake - clockUs);
+    if (wake == scripted && notifications == 0) break;  // let the simulator run it
+  }
+  uint32_t taken = notifications;
+  notifications = clearOnExit ? 0 : (taken ? taken - 1 : 0);
+  return taken;
+}
+
+// ====== TASK WATCHDOG ======
+esp_err_t esp_task_wdt_init(int timeoutSeconds, bool) {
+  wdtTimeoutUs = (uint64_t)timeoutSeconds * 1000000;
+  return 0;
+}
+
+esp_err_t esp_task_wdt_add(void*) {
+  wdtWatching = true;
+  wdtFedUs = clockUs;
+  return 0;
+}
+
+esp_err_t esp_task_wdt_reset() {
+  wdtFedUs = clockUs;
+  return 0;
+}
+
+esp_err_t esp_task_wdt_delete(void*) {
+  wdtWatching = false;
+  return 0;
+}
@@ -0,0 +1,509 @@
+// In-memory Realtime Database behind the Firebase_ESP_Client API.
+// The tree is stored as flattened leaves ("/devices/X/status/online" → "true");
+// objects exist only implicitly through their leaves, as in RTDB.
+#include <Firebase_ESP_Client.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "hal_internal.h"
+
+namespace {
+
+std::map<std::string, std::string> leaves;
+std::vector<FirebaseData*> streams;
+hal::RtdbStats stats;
+bool begun = false;
+const FirebaseConfig* firebaseConfig = nullptr;   // the client gives up at its timeouts
+bool streamLinkWasUp = false;
+unsigned linkEpoch = 0;   // bumped when the link drops: every TLS session dies with it
+
+// ESP32 at 240 MHz, ECDHE-RSA against the RTDB front end: both directions
+// of the exchange, certificate chain included
+const unsigned TLS_HANDSHAKE_MS = 850;
+const unsigned TLS_HANDSHAKE_BYTES = 5600;
+
+std::string normalize(const std::string& path) {
+  std::string out = "/";
+  for (char c : path) {
+    if (c == '/' && out.back() == '/') continue;
+    out += c;
+  }
+  if (out.size() > 1 && out.back() == '/') out.pop_back();
+  return out;
+}
+
+std::string join(const std::string& base, const std::string& key) {
+  return normalize(base + "/" + key);
+}
+
+bool isUnder(const std::string& path, const std::string& root) {
+  if (root == "/") return true;
+  return path.compare(0, root.size(), root) == 0 && (path.size() == root.size() || path[root.size()] == '/');
+}
+
+std::string childPrefix(const std::string& path) {
+  return path == "/" ? path : path + "/";
+}
+
+void eraseSubtree(const std::string& path) {
+  leaves.erase(path);
+  auto it = leaves.lower_bound(childPrefix(path));
+  while (it != leaves.end() && isUnder(it->first, path)) it = leaves.erase(it);
+}
+
+// ====== JSON ======
+void skipSpace(const std::string& s, size_t& i) {
+  while (i < s.size() && isspace((unsigned char)s[i])) i++;
+}
+
+std::string scanString(const std::string& s, size_t& i) {
+  size_t start = i++;
+  while (i < s.size() && s[i] != '"') i += (s[i] == '\\') ? 2 : 1;
+  i++;
+  return s.substr(start, i - start);
+}
+
+std::string unquote(const std::string& raw) {
+  if (raw.size() < 2 || raw[0] != '"') return raw;
+  std::string out;
+  for (size_t i = 1; i + 1 < raw.size(); i++) {
+    if (raw[i] == '\\' && i + 2 < raw.size()) i++;
+    out += raw[i];
+  }
+  return out;
+}
+
+// Writes the value at s[i] under `path`; null deletes, objects recurse
+bool parseValue(const std::string& s, size_t& i, const std::string& path) {
+  skipSpace(s, i);
+  if (i >= s.size()) return false;
+
+  if (s[i] == '{') {
+    i++;
+    skipSpace(s, i);
+    if (s[i] == '}') { i++; return true; }
+    while (i < s.size()) {
+      skipSpace(s, i);
+      if (s[i] != '"') return false;
+      std::string key = unquote(scanString(s, i));
+      skipSpace(s, i);
+      if (s[i++] != ':') return false;
+      if (!parseValue(s, i, join(path, key))) return false;
+      skipSpace(s, i);
+      if (s[i] == ',') { i++; continue; }
+      if (s[i] == '}') { i++; return true; }
+      return false;
+    }
+    return false;
+  }
+
+  std::string token;
+  if (s[i] == '"') {
+    token = scanString(s, i);
+  } else {
+    size_t start = i;
+    while (i < s.size() && s[i] != ',' && s[i] != '}' && !isspace((unsigned char)s[i])) i++;
+    token = s.substr(start, i - start);
+  }
+  eraseSubtree(path);
+  if (token != "null") leaves[path] = token;
+  return true;
+}
+
+void dumpSubtree(const std::string& root, std::string& out) {
+  auto exact = leaves.find(root);
+  if (exact != leaves.end()) {
+    out += exact->second;
+    return;
+  }
+
+  std::string prefix = childPrefix(root);
+  auto it = leaves.lower_bound(prefix);
+  if (it == leaves.end() || !isUnder(it->first, root)) {
+    out += "null";
+    return;
+  }
+
+  out += "{";
+  bool first = true;
+  while (it != leaves.end() && isUnder(it->first, root)) {
+    std::string rest = it->first.substr(prefix.size());
+    std::string key = rest.substr(0, rest.find('/'));
+    if (!first) out += ",";
+    first = false;
+    out += "\"" + key + "\":";
+    std::string child = prefix + key;
+    dumpSubtree(child, out);
+    while (it != leaves.end() && isUnder(it->first, child)) ++it;
+  }
+  out += "}";
+}
+
+const char* typeOf(const std::string& raw) {
+  if (raw.empty() || raw == "null") return "null";
+  if (raw[0] == '{') return "json";
+  if (raw[0] == '"') return "string";
+  if (raw == "true" || raw == "false") return "boolean";
+  return raw.find_first_of(".eE") == std::string::npos ? "int" : "float";
+}
+
+// ====== STREAMS ======
+void deliver(FirebaseData* stream, const std::string& relPath, const std::string& raw) {
+  if (!stream->streamCallback_) return;
+  FirebaseStream event;
+  event.stream_ = stream->streamPath_;
+  event.path_ = relPath.c_str();
+  event.type_ = typeOf(raw);
+  event.str_ = unquote(raw).c_str();
+  if (raw[0] == '{') event.json_.setJsonData(raw.c_str());
+  stats.streamEvents++;
+  stream->streamCallback_(event);
+}
+
+void deliverSnapshot(FirebaseData* stream) {
+  std::string raw;
+  dumpSubtree(stream->streamPath_.c_str(), raw);
+  deliver(stream, "/", raw);
+}
+
+void notifyStreams(const std::string& changed) {
+  if (!hal::detail::linkUp()) return;
+  for (FirebaseData* stream : streams) {
+    std::string root = stream->streamPath_.c_str();
+    if (isUnder(changed, root)) {
+      std::string raw;
+      dumpSubtree(changed, raw);
+      deliver(stream, changed.size() == root.size() ? "/" : changed.substr(root.size()), raw);
+    } else if (isUnder(root, changed)) {
+      deliverSnapshot(stream);
+    }
+  }
+}
+
+// Every device-side call goes through here: counts it and fails it when
+// the link is down, blocking for failureCostMs like a socket timeout, cut
+// short at the client's connect or response timeout. A
+// FirebaseData without a live session pays a full handshake first; a failed
+// request closes its session, like the library does. A request that gets
+// through blocks for one round trip, which is what the sim's awake % sees.
+bool request(FirebaseData* fbdo, bool write, size_t bytes) {
+  stats.requests++;
+  if (write) stats.writes++; else stats.reads++;
+  stats.bytesUp += bytes;
+  fbdo->payloadLength_ = 0;
+  bool live = fbdo->session_ && fbdo->linkEpoch_ == linkEpoch;
+  if (!hal::detail::linkUp()) {
+    stats.failures++;
+    fbdo->session_ = false;
+    fbdo->code_ = -1;
+    fbdo->err_ = hal::network().wifiUp ? "response read timed out" : "connection refused";
+    unsigned long cost = hal::network().failureCostMs;
+    if (firebaseConfig) {
+      cost = std::min(cost, live ? firebaseConfig->timeout.serverResponse : firebaseConfig->timeout.socketConnection);
+    }
+    if (cost) delay(cost);
+    return false;
+  }
+  if (!live) {
+    stats.handshakes++;
+    stats.handshakeBytes += TLS_HANDSHAKE_BYTES;
+    delay(TLS_HANDSHAKE_MS);
+    fbdo->session_ = true;
+    fbdo->linkEpoch_ = linkEpoch;
+  }
+  if (hal::network().roundTripMs) delay(hal::network().roundTripMs);
+  fbdo->code_ = 200;
+  fbdo->err_ = "";
+  return true;
+}
+
+// RTDB answers a write with the value written
+void respond(FirebaseData* fbdo, size_t bytes) {
+  fbdo->payloadLength_ = (int)bytes;
+  stats.bytesDown += bytes;
+}
+
+bool setLeaf(FirebaseData* fbdo, const char* path, const std::string& raw) {
+  std::string p = normalize(path);
+  if (!request(fbdo, true, p.size() + raw.size())) return false;
+  respond(fbdo, raw.size());
+  eraseSubtree(p);
+  leaves[p] = raw;
+  notifyStreams(p);
+  return true;
+}
+
+bool getLeaf(FirebaseData* fbdo, const char* path, const char* wanted) {
+  hal::LibraryCall lib;
+  std::string p = normalize(path);
+  if (!request(fbdo, false, p.size())) return false;
+  fbdo->path_ = p.c_str();
+
+  std::string raw;
+  dumpSubtree(p, raw);
+  respond(fbdo, raw.size());
+  std::string type = typeOf(raw);
+  fbdo->type_ = type.c_str();
+  if (raw == "null") {
+    fbdo->code_ = 404;
+    fbdo->err_ = "path not exist";
+    return false;
+  }
+  bool numeric = (type == "int" || type == "float");
+  bool ok = wanted == nullptr || type == wanted || (numeric && (!strcmp(wanted, "int") || !strcmp(wanted, "float")));
+  if (!ok) {
+    fbdo->err_ = "data type mismatch";
+    return false;
+  }
+  fbdo->str_ = unquote(raw).c_str();
+  if (type == "json") fbdo->json_.setJsonData(raw.c_str());
+  return true;
+}
+
+std::string quote(const char* value) {
+  std::string out = "\"";
+  for (const char* v = value; *v; v++) {
+    char c = *v;
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out + "\"";
+}
+
+}  // namespace
+
+namespace hal {
+
+Network& network() {
+  static Network n;
+  return n;
+}
+
+RtdbStats& rtdbStats() { return stats; }
+
+void rtdbPut(const std::string& path, const std::string& json) {
+  std::string p = normalize(path);
+  size_t i = 0;
+  eraseSubtree(p);
+  parseValue(json, i, p);
+  notifyStreams(p);
+}
+
+void rtdbDelete(const std::string& path) {
+  std::string p = normalize(path);
+  eraseSubtree(p);
+  notifyStreams(p);
+}
+
+bool rtdbGet(const std::string& path, std::string& json) {
+  json.clear();
+  dumpSubtree(normalize(path), json);
+  return json != "null";
+}
+
+size_t rtdbCount(const std::string& prefix) {
+  std::string p = normalize(prefix);
+  size_t n = leaves.count(p);
+  for (auto it = leaves.lower_bound(childPrefix(p)); it != leaves.end() && isUnder(it->first, p); ++it) n++;
+  return n;
+}
+
+size_t rtdbChildren(const std::string& path) {
+  std::string p = normalize(path);
+  std::string prefix = childPrefix(p);
+  size_t n = 0;
+  auto it = leaves.lower_bound(prefix);
+  while (it != leaves.end() && isUnder(it->first, p)) {
+    std::string rest = it->first.substr(prefix.size());
+    std::string child = prefix + rest.substr(0, rest.find('/'));
+    n++;
+    while (it != leaves.end() && isUnder(it->first, child)) ++it;
+  }
+  return n;
+}
+
+namespace detail {
+
+bool linkUp() { return begun && stationUp() && network().backendUp; }
+
+// Streams drop with the link; on reconnect the server replays the whole
+// watched subtree as a put at "/", just like RTDB's event stream.
+void serviceStreams() {
+  LibraryCall lib;
+  bool up = linkUp();
+  if (!up && streamLinkWasUp) linkEpoch++;
+  if (up && !streamLinkWasUp) {
+    for (FirebaseData* stream : streams) deliverSnapshot(stream);
+  }
+  streamLinkWasUp = up;
+}
+
+}  // namespace detail
+}  // namespace hal
+
+// ====== FIREBASE API ======
+FirebaseClass Firebase;
+
+// The real library parses into its own heap-backed tree
+bool FirebaseJson::setJsonData(const char* s) {
+  hal::LibraryCall lib;
+  data = s;
+  return true;
+}
+
+void FirebaseClass::begin(FirebaseConfig* config, FirebaseAuth*) {
+  begun = true;
+  firebaseConfig = config;
+}
+
+bool FirebaseClass::signUp(FirebaseConfig*, FirebaseAuth* auth, const char*, const char*) {
+  hal::LibraryCall lib;
+  if (!hal::detail::linkUp()) return false;
+  auth->token.uid = "host-sim";
+  return true;
+}
+
+bool FirebaseClass::ready() { return hal::detail::linkUp(); }
+
+bool FirebaseData::httpConnected() {
+  hal::LibraryCall lib;
+  if (streamPath_.length() > 0) {
+    for (FirebaseData* stream : streams) {
+      if (stream == this) return hal::detail::linkUp();
+    }
+    return false;
+  }
+  return session_ && linkEpoch_ == linkEpoch && hal::detail::linkUp();
+}
+
+bool RTDBClass::setInt(FirebaseData* fbdo, const char* path, long long value) {
+  hal::LibraryCall lib;
+  return setLeaf(fbdo, path, std::to_string(value));
+}
+
+bool RTDBClass::setDouble(FirebaseData* fbdo, const char* path, double value) {
+  hal::LibraryCall lib;
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.9g", value);
+  return setLeaf(fbdo, path, buf);
+}
+
+bool RTDBClass::setBool(FirebaseData* fbdo, const char* path, bool value) {
+  hal::LibraryCall lib;
+  return setLeaf(fbdo, path, value ? "true" : "false");
+}
+
+bool RTDBClass::setString(FirebaseData* fbdo, const char* path, const char* value) {
+  hal::LibraryCall lib;
+  return setLeaf(fbdo, path, quote(value));
+}
+
+bool RTDBClass::setJSON(FirebaseData* fbdo, const char* path, FirebaseJson* json) {
+  hal::LibraryCall lib;
+  std::string p = normalize(path);
+  if (!request(fbdo, true, p.size() + json->data.length())) return false;
+  respond(fbdo, json->data.length());
+  size_t i = 0;
+  eraseSubtree(p);
+  parseValue(json->data.s, i, p);
+  notifyStreams(p);
+  return true;
+}
+
+bool RTDBClass::getString(FirebaseData* fbdo, const char* path) { return getLeaf(fbdo, path, "string"); }
+bool RTDBClass::getInt(FirebaseData* fbdo, const char* path) { return getLeaf(fbdo, path, "int"); }
+bool RTDBClass::getDouble(FirebaseData* fbdo, const char* path) { return getLeaf(fbdo, path, "float"); }
+bool RTDBClass::getBool(FirebaseData* fbdo, const char* path) { return getLeaf(fbdo, path, "boolean"); }
+bool RTDBClass::getJSON(FirebaseData* fbdo, const char* path) { return getLeaf(fbdo, path, "json"); }
+
+bool RTDBClass::deleteNode(FirebaseData* fbdo, const char* path) {
+  hal::LibraryCall lib;
+  std::string p = normalize(path);
+  if (!request(fbdo, true, p.size())) return false;
+  respond(fbdo, 4);  // null
+  eraseSubtree(p);
+  notifyStreams(p);
+  return true;
+}
+
+namespace {
+
+// Multi-location update: every top-level key is a path relative to `path`
+// and replaces whatever was there. The silent form gets 204 No Content
+// instead of the echo.
+bool update(FirebaseData* fbdo, const char* path, FirebaseJson* json, bool silent) {
+  hal::LibraryCall lib;
+  std::string base = normalize(path);
+  const std::string& s = json->data.s;
+  if (!request(fbdo, true, base.size() + s.size())) return false;
+  if (!silent) respond(fbdo, s.size());
+
+  size_t i = 0;
+  skipSpace(s, i);
+  if (i >= s.size() || s[i] != '{') {
+    fbdo->code_ = 400;
+    fbdo->err_ = "invalid JSON";
+    return false;
+  }
+  i++;
+  std::vector<std::string> changed;
+  while (i < s.size()) {
+    skipSpace(s, i);
+    if (s[i] == '}') break;
+    std::string key = unquote(scanString(s, i));
+    skipSpace(s, i);
+    i++;  // ':'
+    std::string target = join(base, key);
+    eraseSubtree(target);
+    if (!parseValue(s, i, target)) {
+      fbdo->code_ = 400;
+      fbdo->err_ = "invalid JSON";
+      return false;
+    }
+    changed.push_back(target);
+    skipSpace(s, i);
+    if (s[i] == ',') i++;
+  }
+  for (const std::string& target : changed) notifyStreams(target);
+  if (silent) fbdo->code_ = 204;
+  return true;
+}
+
+}  // namespace
+
+bool RTDBClass::updateNode(FirebaseData* fbdo, const char* path, FirebaseJson* json) {
+  return update(fbdo, path, json, false);
+}
+
+bool RTDBClass::updateNodeSilent(FirebaseData* fbdo, const char* path, FirebaseJson* json) {
+  return update(fbdo, path, json, true);
+}
+
+bool RTDBClass::beginStream(FirebaseData* fbdo, const char* path) {
+  hal::LibraryCall lib;
+  if (!request(fbdo, false, strlen(path))) return false;
+  fbdo->streamPath_ = normalize(path).c_str();
+  for (FirebaseData* stream : streams) {
+    if (stream == fbdo) return true;
+  }
+  streams.push_back(fbdo);
+  return true;
+}
+
+void RTDBClass::setStreamCallback(FirebaseData* fbdo, FirebaseData_StreamEventCallback dataCallback,
+                                  FirebaseData_StreamTimeoutCallback timeoutCallback, size_t) {
+  hal::LibraryCall lib;
+  fbdo->streamCallback_ = dataCallback;
+  fbdo->timeoutCallback_ = timeoutCallback;
+  if (hal::detail::linkUp()) deliverSnapshot(fbdo);
+}
+
+void RTDBClass::endStream(FirebaseData* fbdo) {
+  hal::LibraryCall lib;
+  for (size_t i = 0; i < streams.size(); i++) {
+    if (streams[i] == fbdo) {
+      streams.erase(streams.begin() + i);
+      break;
+    }
+  }
+}
@@ -0,0 +1,35 @@
+#pragma once
+// Shared between the HAL translation units only.
+#include "hal.h"
+
+namespace hal {
+namespace detail {
+
+// Called after every clock advance: delivers due UART replies and
+// reconnects RTDB streams when the link comes back.
+void serviceUart();
+void serviceStreams();
+uint64_t nextUartReplyUs();   // UINT64_MAX when none is in flight
+uint64_t nextSntpUs();        // next SNTP answer, UINT64_MAX when none is due
+uint64_t nextGpioEdgeUs();    // next scheduled input edge, UINT64_MAX when none
+void serviceGpio();           // applies edges due now and runs their interrupts
+
+uint64_t nextWiFiUs();        // next join result, UINT64_MAX when none is pending
+void serviceWiFi();           // link loss and join results, with their events
+bool stationUp();             // associated with the AP and it is in range
+void resetWiFi();             // ESP.restart(): station down, event handlers gone
+bool linkUp();   // WiFi associated and backend reachable
+uint32_t nextRandom();
+
+}  // namespace detail
+
+// Scope guard for HAL entry points that stand in for library code: heap
+// use inside is not charged to the firmware by the allocation audit.
+class LibraryCall {
+ public:
+  LibraryCall();
+  ~LibraryCall();
+  LibraryCall(const LibraryCall&) = delete;
+  LibraryCall& operator=(const LibraryCall&) = delete;
+};
+}  // namespace hal
@@ -0,0 +1,217 @@
+// In-memory LittleFS. Space is accounted in 4 KiB blocks like the real
+// filesystem, so the backlog and history rings hit the same limits. The VFS
+// allocates file handles on the device too, so calls count as library work
+// for the heap audit.
+#include <LittleFS.h>
+#include <algorithm>
+#include <map>
+#include "hal_internal.h"
+
+struct HostFsNode {
+  bool dir = false;
+  std::vector<uint8_t> data;
+};
+
+namespace {
+
+const size_t FS_BLOCK = 4096;
+const size_t FS_TOTAL = 0x160000;   // default 4 MB partition table
+
+std::map<std::string, std::shared_ptr<HostFsNode>> nodes;
+bool mounted = false;
+
+std::string parentOf(const std::string& path) {
+  size_t slash = path.rfind('/');
+  return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+std::string baseName(const std::string& path) {
+  return path.substr(path.rfind('/') + 1);
+}
+
+size_t blocksFor(const HostFsNode& node) {
+  return node.dir ? 1 : 1 + (node.data.size() + FS_BLOCK - 1) / FS_BLOCK;
+}
+
+size_t usedBlocks() {
+  size_t blocks = 2;  // superblock pair
+  for (auto& entry : nodes) blocks += blocksFor(*entry.second);
+  return blocks;
+}
+
+void ensureRoot() {
+  if (!nodes.count("/")) {
+    nodes["/"] = std::make_shared<HostFsNode>();
+    nodes["/"]->dir = true;
+  }
+}
+
+void makeParents(const std::string& path) {
+  std::string parent = parentOf(path);
+  if (nodes.count(parent)) return;
+  makeParents(parent);
+  auto dir = std::make_shared<HostFsNode>();
+  dir->dir = true;
+  nodes[parent] = dir;
+}
+
+}  // namespace
+
+namespace hal {
+
+size_t fsUsedBytes() { return usedBlocks() * FS_BLOCK; }
+
+size_t fsFileCount(const std::string& prefix) {
+  size_t n = 0;
+  for (auto& entry : nodes) {
+    if (!entry.second->dir && entry.first.compare(0, prefix.size(), prefix) == 0) n++;
+  }
+  return n;
+}
+
+}  // namespace hal
+
+LittleFSFS LittleFS;
+
+// ====== FILE ======
+size_t File::write(const uint8_t* buf, size_t n) {
+  hal::LibraryCall lib;
+  if (!node_ || node_->dir || !writable_) return 0;
+  size_t end = pos_ + n;
+  size_t growBlocks = 0;
+  if (end > node_->data.size()) {
+    size_t before = (node_->data.size() + FS_BLOCK - 1) / FS_BLOCK;
+    size_t after = (end + FS_BLOCK - 1) / FS_BLOCK;
+    growBlocks = after - before;
+  }
+  if ((usedBlocks() + growBlocks) * FS_BLOCK > FS_TOTAL) return 0;  // ENOSPC
+  if (end > node_->data.size()) node_->data.resize(end);
+  memcpy(node_->data.data() + pos_, buf, n);
+  pos_ = end;
+  return n;
+}
+
+size_t File::read(uint8_t* buf, size_t n) {
+  if (!node_ || node_->dir || pos_ >= node_->data.size()) return 0;
+  size_t count = std::min(n, node_->data.size() - pos_);
+  memcpy(buf, node_->data.data() + pos_, count);
+  pos_ += count;
+  return count;
+}
+
+bool File::seek(uint32_t pos) {
+  if (!node_ || pos > node_->data.size()) return false;
+  pos_ = pos;
+  return true;
+}
+
+size_t File::size() const { return node_ && !node_->dir ? node_->data.size() : 0; }
+
+bool File::isDirectory() const { return node_ && node_->dir; }
+
+// Children in name order; name() is the bare file name (core 2.x behaviour)
+File File::openNextFile() {
+  hal::LibraryCall lib;
+  File next;
+  if (!node_ || !node_->dir) return next;
+  std::string prefix = path_ == "/" ? "/" : path_ + "/";
+  size_t index = 0;
+  for (auto it = nodes.lower_bound(prefix); it != nodes.end(); ++it) {
+    if (it->first.compare(0, prefix.size(), prefix) != 0) break;
+    if (it->first == "/" || parentOf(it->first) != path_) continue;
+    if (index++ < iter_) continue;
+    iter_++;
+    next.node_ = it->second;
+    next.path_ = it->first;
+    next.name_ = baseName(it->first);
+    return next;
+  }
+  return next;
+}
+
+// ====== FILESYSTEM ======
+bool LittleFSFS::begin(bool, const char*, uint8_t, const char*) {
+  hal::LibraryCall lib;
+  ensureRoot();
+  mounted = true;
+  return true;
+}
+
+bool LittleFSFS::format() {
+  hal::LibraryCall lib;
+  nodes.clear();
+  ensureRoot();
+  return true;
+}
+
+File LittleFSFS::open(const char* path, const char* mode) {
+  hal::LibraryCall lib;
+  File file;
+  if (!mounted) return file;
+  std::string p = path;
+  auto it = nodes.find(p);
+
+  if (mode[0] == 'r') {
+    if (it == nodes.end()) return file;
+    file.node_ = it->second;
+  } else {
+    if (it != nodes.end() && it->second->dir) return file;
+    makeParents(p);
+    if (it == nodes.end()) it = nodes.emplace(p, std::make_shared<HostFsNode>()).first;
+    if (mode[0] == 'w') it->second->data.clear();
+    file.node_ = it->second;
+    file.writable_ = true;
+    if (mode[0] == 'a') file.pos_ = it->second->data.size();
+  }
+  file.path_ = p;
+  file.name_ = baseName(p);
+  return file;
+}
+
+bool LittleFSFS::exists(const char* path) {
+  hal::LibraryCall lib;
+  return nodes.count(path) > 0;
+}
+
+bool LittleFSFS::remove(const char* path) {
+  hal::LibraryCall lib;
+  auto it = nodes.find(path);
+  if (it == nodes.end() || it->second->dir) return false;
+  nodes.erase(it);
+  return true;
+}
+
+bool LittleFSFS::mkdir(const char* path) {
+  hal::LibraryCall lib;
+  if (nodes.count(path)) return false;
+  makeParents(path);
+  auto dir = std::make_shared<HostFsNode>();
+  dir->dir = true;
+  nodes[path] = dir;
+  return true;
+}
+
+bool LittleFSFS::rmdir(const char* path) {
+  hal::LibraryCall lib;
+  std::string prefix = std::string(path) + "/";
+  auto child = nodes.lower_bound(prefix);
+  if (child != nodes.end() && child->first.compare(0, prefix.size(), prefix) == 0) return false;
+  return nodes.erase(path) > 0;
+}
+
+bool LittleFSFS::rename(const char* from, const char* to) {
+  hal::LibraryCall lib;
+  auto it = nodes.find(from);
+  if (it == nodes.end() || it->second->dir) return false;
+  auto node = it->second;
+  nodes.erase(it);
+  makeParents(to);
+  nodes[to] = node;
+  return true;
+}
+
+size_t LittleFSFS::totalBytes() { return FS_TOTAL; }
+size_t LittleFSFS::usedBytes() {
+  hal::LibraryCall lib;
+  return hal::fsUsedBytes();
+}
@@ -0,0 +1,158 @@
+#pragma once
+// Host stand-in for the subset of the ESP32 Arduino core used by src/main.cpp.
+// Timing, GPIO and UART are backed by the simulation in host/hal.
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cstdarg>
+#include <cmath>
+#include <string>
+#include <functional>
+#include <ctime>
+#include <algorithm>
+using std::isnan;
+using std::min;
+using std::max;
+
+// newlib (ESP-IDF) and BSD libcs have strlcpy; glibc only since 2.38
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+#define HOST_NEEDS_STRLCPY 1
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+typedef uint8_t byte;
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+#define IRAM_ATTR
+#define ADC_11db 3
+#define constrain(x,a,b) ((x)<(a)?(a):((x)>(b)?(b):(x)))
+#define SERIAL_8N1 0x800001c
+
+class String {
+ public:
+  std::string s;
+  String() {}
+  String(const char* c) : s(c ? c : "") {}
+  String(const std::string& c) : s(c) {}
+  String(char c) : s(1, c) {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+  String(long long v) : s(std::to_string(v)) {}
+  String(unsigned long long v) : s(std::to_string(v)) {}
+  String(float v, int d = 2) { char b[48]; snprintf(b, sizeof b, "%.*f", d, v); s = b; }
+  String(double v, int d = 2) { char b[48]; snprintf(b, sizeof b, "%.*f", d, v); s = b; }
+  const char* c_str() const { return s.c_str(); }
+  unsigned length() const { return s.size(); }
+  bool reserve(unsigned n) { s.reserve(n); return true; }
+  char operator[](unsigned i) const { return i < s.size() ? s[i] : 0; }
+  String& operator+=(const String& o) { s += o.s; return *this; }
+  String& operator+=(const char* o) { s += o; return *this; }
+  String& operator+=(char c) { s += c; return *this; }
+  bool operator==(const String& o) const { return s == o.s; }
+  bool operator==(const char* o) const { return s == o; }
+  bool operator!=(const String& o) const { return s != o.s; }
+  bool operator!=(const char* o) const { return s != o; }
+  bool equals(const char* o) const { return s == o; }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return atof(s.c_str()); }
+  bool startsWith(const char* p) const { return s.rfind(p, 0) == 0; }
+  bool endsWith(const char* p) const { size_t n = strlen(p); return s.size() >= n && s.compare(s.size() - n, n, p) == 0; }
+  int indexOf(const char* p) const { auto i = s.find(p); return i == std::string::npos ? -1 : (int)i; }
+  int indexOf(char c) const { auto i = s.find(c); return i == std::string::npos ? -1 : (int)i; }
+  int lastIndexOf(char c) const { auto i = s.rfind(c); return i == std::string::npos ? -1 : (int)i; }
+  String substring(unsigned a) const { return a < s.size() ? String(s.substr(a)) : String(); }
+  String substring(unsigned a, unsigned b) const { return a < s.size() ? String(s.substr(a, b - a)) : String(); }
+  void trim() { size_t a = s.find_first_not_of(" \t\r\n"); size_t b = s.find_last_not_of(" \t\r\n"); s = a == std::string::npos ? "" : s.substr(a, b - a + 1); }
+  void toLowerCase() { for (auto& c : s) c = (char)tolower((unsigned char)c); }
+};
+inline String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+inline String operator+(const String& a, const char* b) { return String(a.s + b); }
+inline String operator+(const char* a, const String& b) { return String(a + b.s); }
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) { return write(&b, 1); }
+  virtual size_t write(const uint8_t* buf, size_t n) = 0;
+  size_t print(const String& v) { return write((const uint8_t*)v.c_str(), v.length()); }
+  size_t print(const char* v) { return write((const uint8_t*)v, strlen(v)); }
+  size_t print(char v) { return write((uint8_t)v); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(unsigned char v) { return printf("%u", v); }
+  size_t print(short v) { return printf("%d", v); }
+  size_t print(unsigned short v) { return printf("%u", v); }
+  size_t print(long long v) { return printf("%lld", v); }
+  size_t print(unsigned long long v) { return printf("%llu", v); }
+  size_t print(bool v) { return printf("%d", v); }
+  size_t print(float v, int d = 2) { return printf("%.*f", d, (double)v); }
+  size_t print(double v, int d = 2) { return printf("%.*f", d, v); }
+  template <typename T> auto print(const T& v) -> decltype(v.printTo(*this)) { return v.printTo(*this); }
+  size_t println() { return print("\r\n"); }
+  template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  size_t println(const struct tm* t, const char* fmt) { char b[64]; strftime(b, sizeof b, fmt, t); return println(b); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+#define UART_MODE_RS485_HALF_DUPLEX 1
+class HardwareSerial : public Print {
+ public:
+  explicit HardwareSerial(int uartNum) : uart_(uartNum) {}
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int rxPin = -1, int txPin = -1);
+  int available();
+  int read();
+  using Print::write;
+  size_t write(const uint8_t* buf, size_t n) override;
+  void flush() {}
+  void setPins(int, int, int = -1, int = -1) {}
+  bool setMode(int) { return true; }
+  bool setRxTimeout(uint8_t) { return true; }
+  void onReceive(std::function<void(void)> cb, bool = false) { onReceive_ = cb; }
+
+  int uart_;
+  unsigned long baud_ = 0;
+  std::function<void(void)> onReceive_;
+};
+extern HardwareSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void analogSetPinAttenuation(uint8_t pin, int attenuation);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout = 1000000);
+#define digitalPinToInterrupt(pin) (pin)
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+long random(long max);
+long random(long min, long max);
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+void configTime(long gmtOffset, int daylightOffset, const char* server1, const char* server2 = nullptr, const char* server3 = nullptr);
+
+class EspClass {
+ public:
+  uint32_t getFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getCycleCount();
+  [[noreturn]] void restart();
+};
+extern EspClass ESP;
+
+#include <freertos_shim.h>
@@ -0,0 +1,245 @@
+#pragma once
+// Minimal host stand-in for the subset of ArduinoJson 6 used by the firmware.
+// Like the real StaticJsonDocument, a document lives in a fixed pool and never
+// touches the heap: when the pool is full, writes are dropped and
+// overflowed() turns true. Capacity is accounted as on the ESP32 (16-byte
+// slots, copied strings), the host pool is larger to fit 64-bit nodes.
+#include <Arduino.h>
+
+struct JsonNode {
+  enum Type : uint8_t { NUL, OBJECT, RAW, STRING };
+  const char* key;
+  const char* text;   // RAW: JSON literal, STRING: unescaped value
+  JsonNode* first;
+  JsonNode* last;
+  JsonNode* next;
+  Type type;
+};
+
+class JsonVariant;
+class JsonObject;
+
+class JsonDocument {
+ public:
+  JsonDocument(const JsonDocument&) = delete;
+  JsonDocument& operator=(const JsonDocument&) = delete;
+
+  JsonVariant operator[](const char* key);
+  JsonVariant operator[](char* key);
+  JsonVariant operator[](const String& key);
+  JsonObject createNestedObject(const char* key);
+  JsonObject createNestedObject(char* key);
+  JsonObject createNestedObject(const String& key);
+
+  void clear() {
+    used_ = 0;
+    usage_ = 0;
+    overflowed_ = false;
+    root_ = newNode(nullptr);
+    if (root_) root_->type = JsonNode::OBJECT;
+  }
+  size_t size() const {
+    size_t n = 0;
+    for (JsonNode* c = root_ ? root_->first : nullptr; c; c = c->next) n++;
+    return n;
+  }
+  bool overflowed() const { return overflowed_; }
+  size_t memoryUsage() const { return usage_; }
+  size_t capacity() const { return capacity_; }
+  const JsonNode* root() const { return root_; }
+
+  // Pool primitives shared with JsonVariant/JsonObject
+  JsonNode* newNode(const char* key) {
+    size_t at = (used_ + alignof(JsonNode) - 1) & ~(alignof(JsonNode) - 1);
+    if (!charge(SLOT_SIZE) || at + sizeof(JsonNode) > poolSize_) return fail<JsonNode>();
+    JsonNode* node = reinterpret_cast<JsonNode*>(pool_ + at);
+    used_ = at + sizeof(JsonNode);
+    *node = JsonNode{key, nullptr, nullptr, nullptr, nullptr, JsonNode::NUL};
+    return node;
+  }
+  // deviceBytes: what the copy costs in the real pool (numbers are inline)
+  const char* copyText(const char* s, size_t deviceBytes) {
+    size_t n = strlen(s) + 1;
+    if (!charge(deviceBytes) || used_ + n > poolSize_) return fail<const char>();
+    char* out = pool_ + used_;
+    memcpy(out, s, n);
+    used_ += n;
+    return out;
+  }
+  const char* copyString(const char* s) { return copyText(s, strlen(s) + 1); }
+
+  JsonNode* child(JsonNode* parent, const char* key, bool copyKey) {
+    if (!parent) return nullptr;
+    if (parent->type != JsonNode::OBJECT) {
+      parent->type = JsonNode::OBJECT;
+      parent->first = parent->last = nullptr;
+    }
+    for (JsonNode* c = parent->first; c; c = c->next) {
+      if (strcmp(c->key, key) == 0) return c;
+    }
+    if (copyKey && !(key = copyString(key))) return nullptr;
+    JsonNode* node = newNode(key);
+    if (!node) return nullptr;
+    if (parent->last) parent->last->next = node; else parent->first = node;
+    parent->last = node;
+    return node;
+  }
+
+ protected:
+  JsonDocument(char* pool, size_t poolSize, size_t capacity)
+      : pool_(pool), poolSize_(poolSize), capacity_(capacity) { clear(); }
+
+ private:
+  static const size_t SLOT_SIZE = 16;   // VariantSlot on a 32-bit target
+
+  bool charge(size_t bytes) {
+    if (usage_ + bytes > capacity_) return false;
+    usage_ += bytes;
+    return true;
+  }
+  template <typename T> T* fail() { overflowed_ = true; return nullptr; }
+
+  char* pool_;
+  size_t poolSize_, capacity_;
+  size_t used_ = 0, usage_ = 0;
+  bool overflowed_ = false;
+  JsonNode* root_ = nullptr;
+};
+
+template <size_t N>
+class StaticJsonDocument : public JsonDocument {
+ public:
+  StaticJsonDocument() : JsonDocument(storage_, sizeof(storage_), N) {}
+ private:
+  alignas(JsonNode) char storage_[N * 5];
+};
+
+class JsonVariant {
+ public:
+  JsonVariant(JsonDocument* doc, JsonNode* node) : doc_(doc), node_(node) {}
+  JsonVariant& operator=(bool v) { return setRaw(v ? "true" : "false"); }
+  JsonVariant& operator=(int v) { return setNumber("%d", v); }
+  JsonVariant& operator=(unsigned v) { return setNumber("%u", v); }
+  JsonVariant& operator=(long v) { return setNumber("%ld", v); }
+  JsonVariant& operator=(unsigned long v) { return setNumber("%lu", v); }
+  JsonVariant& operator=(long long v) { return setNumber("%lld", v); }
+  JsonVariant& operator=(unsigned long long v) { return setNumber("%llu", v); }
+  JsonVariant& operator=(double v) { return std::isfinite(v) ? setNumber("%.9g", v) : setRaw("null"); }
+  JsonVariant& operator=(float v) { return *this = (double)v; }
+  // const char* is stored by pointer, char* and String are copied (as in ArduinoJson)
+  JsonVariant& operator=(const char* v) { return setString(v); }
+  JsonVariant& operator=(char* v) { return setString(node_ ? doc_->copyString(v) : nullptr); }
+  JsonVariant& operator=(const String& v) { return *this = const_cast<char*>(v.c_str()); }
+
+ private:
+  JsonVariant& set(JsonNode::Type type, const char* text) {
+    if (!node_ || !text) return *this;
+    node_->type = type;
+    node_->text = text;
+    node_->first = node_->last = nullptr;
+    return *this;
+  }
+  JsonVariant& setRaw(const char* literal) { return set(JsonNode::RAW, literal); }
+  JsonVariant& setString(const char* s) { return set(JsonNode::STRING, s); }
+  template <typename T> JsonVariant& setNumber(const char* fmt, T v) {
+    if (!node_) return *this;
+    char buf[32];
+    snprintf(buf, sizeof(buf), fmt, v);
+    return set(JsonNode::RAW, doc_->copyText(buf, 0));
+  }
+
+  JsonDocument* doc_;
+  JsonNode* node_;
+};
+
+class JsonObject {
+ public:
+  JsonObject() {}
+  JsonObject(JsonDocument* doc, JsonNode* node) : doc_(doc), node_(node) {
+    if (node_ && node_->type != JsonNode::OBJECT) {
+      node_->type = JsonNode::OBJECT;
+      node_->first = node_->last = nullptr;
+    }
+  }
+  JsonVariant operator[](const char* k) { return JsonVariant(doc_, doc_ ? doc_->child(node_, k, false) : nullptr); }
+  JsonVariant operator[](char* k) { return JsonVariant(doc_, doc_ ? doc_->child(node_, k, true) : nullptr); }
+  JsonVariant operator[](const String& k) { return (*this)[const_cast<char*>(k.c_str())]; }
+  JsonObject createNestedObject(const char* k) { return JsonObject(doc_, doc_ ? doc_->child(node_, k, false) : nullptr); }
+  JsonObject createNestedObject(char* k) { return JsonObject(doc_, doc_ ? doc_->child(node_, k, true) : nullptr); }
+  JsonObject createNestedObject(const String& k) { return createNestedObject(const_cast<char*>(k.c_str())); }
+  bool isNull() const { return !node_; }
+  size_t size() const {
+    size_t n = 0;
+    for (JsonNode* c = node_ ? node_->first : nullptr; c; c = c->next) n++;
+    return n;
+  }
+
+ private:
+  JsonDocument* doc_ = nullptr;
+  JsonNode* node_ = nullptr;
+};
+
+inline JsonVariant JsonDocument::operator[](const char* k) { return JsonVariant(this, child(root_, k, false)); }
+inline JsonVariant JsonDocument::operator[](char* k) { return JsonVariant(this, child(root_, k, true)); }
+inline JsonVariant JsonDocument::operator[](const String& k) { return (*this)[const_cast<char*>(k.c_str())]; }
+inline JsonObject JsonDocument::createNestedObject(const char* k) { return JsonObject(this, child(root_, k, false)); }
+inline JsonObject JsonDocument::createNestedObject(char* k) { return JsonObject(this, child(root_, k, true)); }
+inline JsonObject JsonDocument::createNestedObject(const String& k) { return createNestedObject(const_cast<char*>(k.c_str())); }
+
+// ====== SERIALIZATION ======
+// Counts every byte, stores what fits (ArduinoJson truncates the same way)
+struct JsonWriter {
+  char* out;
+  size_t size;
+  size_t len = 0;
+  void put(char c) {
+    if (out && len + 1 < size) out[len] = c;
+    len++;
+  }
+  void put(const char* s) { while (*s) put(*s++); }
+  void quoted(const char* s) {
+    put('"');
+    for (; *s; s++) {
+      char c = *s;
+      if (c == '"' || c == '\\') { put('\\'); put(c); }
+      else if (c == '\n') put("\\n");
+      else if (c == '\r') put("\\r");
+      else if (c == '\t') put("\\t");
+      else if ((unsigned char)c < 0x20) { char b[8]; snprintf(b, sizeof(b), "\\u%04x", c); put(b); }
+      else put(c);
+    }
+    put('"');
+  }
+  void node(const JsonNode* n) {
+    switch (n ? n->type : JsonNode::NUL) {
+      case JsonNode::OBJECT:
+        put('{');
+        for (const JsonNode* c = n->first; c; c = c->next) {
+          if (c != n->first) put(',');
+          quoted(c->key);
+          put(':');
+          node(c);
+        }
+        put('}');
+        break;
+      case JsonNode::RAW: put(n->text); break;
+      case JsonNode::STRING: quoted(n->text); break;
+      default: put("null"); break;
+    }
+  }
+};
+
+inline size_t measureJson(const JsonDocument& d) {
+  JsonWriter w{nullptr, 0};
+  w.node(d.root());
+  return w.len;
+}
+
+inline size_t serializeJson(const JsonDocument& d, char* out, size_t n) {
+  if (n == 0) return 0;
+  JsonWriter w{out, n};
+  w.node(d.root());
+  size_t len = w.len < n - 1 ? w.len : n - 1;
+  out[len] = 0;
+  return len;
+}
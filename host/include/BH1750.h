@@ -0,0 +1,10 @@
+#pragma once
+#include <Wire.h>
+class BH1750 {
+ public:
+  enum Mode { CONTINUOUS_HIGH_RES_MODE = 0x10 };
+  bool begin(Mode mode = CONTINUOUS_HIGH_RES_MODE, uint8_t addr = 0x23, TwoWire* wire = nullptr);
+  float readLightLevel();
+ private:
+  bool started_ = false;
+};
@@ -0,0 +1,115 @@
+#pragma once
+// Host stand-in for Firebase_ESP_Client backed by an in-memory Realtime
+// Database (host/hal/hal_firebase.cpp). Paths are flattened to leaves;
+// stream callbacks fire synchronously when a watched subtree changes.
+// Paths are plain const char*, as the library's templates accept, so calling
+// it never makes the firmware build a String.
+#include <Arduino.h>
+#include <WiFi.h>
+#include <type_traits>
+
+class FirebaseJson {
+ public:
+  bool setJsonData(const char* s);
+  bool setJsonData(const String& s) { return setJsonData(s.c_str()); }
+  void clear() { data = ""; }
+  bool toString(String& out, bool = false) const { out = data; return true; }
+  String raw() const { return data; }
+  String data;
+};
+
+struct TokenInfo { int status; int type; };
+struct FirebaseAuth { struct { String uid; } token; struct { String email, password; } user; };
+struct FirebaseConfig {
+  String database_url, api_key;
+  void (*token_status_callback)(TokenInfo) = nullptr;
+  struct {
+    unsigned long serverResponse = 10000, socketConnection = 10000, sslHandshake = 10000;
+    unsigned long rtdbKeepAlive = 45000, rtdbStreamReconnect = 1000, rtdbStreamError = 3000;
+    unsigned long wifiReconnect = 10000, networkReconnect = 10000;
+  } timeout;
+  int max_token_generation_retry = 0;
+};
+
+class FirebaseStream {
+ public:
+  String dataPath() { return path_; }
+  String dataType() { return type_; }
+  String stringData() { return str_; }
+  int intData() { return str_.toInt(); }
+  double doubleData() { return str_.toFloat(); }
+  bool boolData() { return str_ == "true"; }
+  FirebaseJson* jsonObjectPtr() { return &json_; }
+  String streamPath() { return stream_; }
+  String path_, type_, str_, stream_;
+  FirebaseJson json_;
+};
+typedef void (*FirebaseData_StreamEventCallback)(FirebaseStream);
+typedef void (*FirebaseData_StreamTimeoutCallback)(bool);
+
+class FirebaseData {
+ public:
+  String stringData() { return str_; }
+  // Borrowed view of the payload, valid until the next request on this object
+  template <typename T>
+  typename std::enable_if<std::is_same<T, const char*>::value, T>::type to() { return str_.c_str(); }
+  int intData() { return str_.toInt(); }
+  float floatData() { return str_.toFloat(); }
+  double doubleData() { return str_.toFloat(); }
+  bool boolData() { return str_ == "true"; }
+  String errorReason() { return err_; }
+  int httpCode() { return code_; }
+  String dataPath() { return path_; }
+  String dataType() { return type_; }
+  FirebaseJson* jsonObjectPtr() { return &json_; }
+  int payloadLength() { return payloadLength_; }
+  void setResponseSize(int) {}
+  void setBSSLBufferSize(int, int) {}
+  void keepAlive(int, int, int) {}
+  bool streamTimeout() { return false; }
+  bool httpConnected();
+
+  String str_, err_, path_, type_;
+  int code_ = 0;
+  int payloadLength_ = 0;
+  bool session_ = false;        // TLS session open, valid while linkEpoch_ is current
+  unsigned linkEpoch_ = 0;
+  FirebaseJson json_;
+  String streamPath_;
+  FirebaseData_StreamEventCallback streamCallback_ = nullptr;
+  FirebaseData_StreamTimeoutCallback timeoutCallback_ = nullptr;
+};
+
+class RTDBClass {
+ public:
+  bool setInt(FirebaseData* fbdo, const char* path, long long value);
+  bool setFloat(FirebaseData* fbdo, const char* path, float value) { return setDouble(fbdo, path, value); }
+  bool setDouble(FirebaseData* fbdo, const char* path, double value);
+  bool setBool(FirebaseData* fbdo, const char* path, bool value);
+  bool setString(FirebaseData* fbdo, const char* path, const char* value);
+  bool setJSON(FirebaseData* fbdo, const char* path, FirebaseJson* json);
+  bool getString(FirebaseData* fbdo, const char* path);
+  bool getInt(FirebaseData* fbdo, const char* path);
+  bool getFloat(FirebaseData* fbdo, const char* path) { return getDouble(fbdo, path); }
+  bool getDouble(FirebaseData* fbdo, const char* path);
+  bool getBool(FirebaseData* fbdo, const char* path);
+  bool getJSON(FirebaseData* fbdo, const char* path);
+  bool deleteNode(FirebaseData* fbdo, const char* path);
+  bool updateNode(FirebaseData* fbdo, const char* path, FirebaseJson* json);
+  bool updateNodeSilent(FirebaseData* fbdo, const char* path, FirebaseJson* json);
+  bool beginStream(FirebaseData* fbdo, const char* path);
+  void setStreamCallback(FirebaseData* fbdo, FirebaseData_StreamEventCallback dataCallback, FirebaseData_StreamTimeoutCallback timeoutCallback, size_t streamTaskStackSize = 0);
+  bool readStream(FirebaseData* fbdo) { return fbdo->httpConnected(); }
+  void endStream(FirebaseData* fbdo);
+  void removeStreamCallback(FirebaseData* fbdo) { fbdo->streamCallback_ = nullptr; fbdo->timeoutCallback_ = nullptr; }
+};
+
+class FirebaseClass {
+ public:
+  RTDBClass RTDB;
+  void reconnectWiFi(bool) {}
+  void begin(FirebaseConfig* config, FirebaseAuth* auth);
+  bool signUp(FirebaseConfig* config, FirebaseAuth* auth, const char* email, const char* password);
+  bool ready();
+};
+extern FirebaseClass Firebase;
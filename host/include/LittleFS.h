@@ -0,0 +1,50 @@
+#pragma once
+// In-memory LittleFS: the image survives simulated restarts and can be
+// inspected from the simulator (hal::fsUsedBytes()).
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+struct HostFsNode;
+class File {
+ public:
+  File() {}
+  explicit operator bool() const { return node_ != nullptr; }
+  size_t write(const uint8_t* buf, size_t n);
+  size_t write(uint8_t b) { return write(&b, 1); }
+  size_t read(uint8_t* buf, size_t n);
+  int read() { uint8_t b; return read(&b, 1) == 1 ? b : -1; }
+  int available() const { return (int)(size() - pos_); }
+  bool seek(uint32_t pos);
+  size_t size() const;
+  size_t position() const { return pos_; }
+  const char* name() const { return name_.c_str(); }
+  const char* path() const { return path_.c_str(); }
+  bool isDirectory() const;
+  File openNextFile();
+  void flush() {}
+  void close() { node_.reset(); }
+
+  std::shared_ptr<HostFsNode> node_;
+  std::string path_, name_;
+  size_t pos_ = 0, iter_ = 0;
+  bool writable_ = false;
+};
+class LittleFSFS {
+ public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+  void end() {}
+  bool format();
+  File open(const char* path, const char* mode = "r");
+  File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool mkdir(const char* path);
+  bool mkdir(const String& path) { return mkdir(path.c_str()); }
+  bool rmdir(const char* path);
+  bool rename(const char* from, const char* to);
+  size_t totalBytes();
+  size_t usedBytes();
+};
+extern LittleFSFS LittleFS;
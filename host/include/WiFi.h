@@ -0,0 +1,64 @@
+#pragma once
+#include <Arduino.h>
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+#define WIFI_STA 1
+class IPAddress {
+ public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{a, b, c, d} {}
+  size_t printTo(Print& p) const { return p.printf("%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]); }
+  uint8_t octets[4];
+};
+
+// Station events (core 2.x). Handlers run from the clock advance, like the
+// WiFi event task on the device.
+typedef enum {
+  ARDUINO_EVENT_WIFI_STA_CONNECTED,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP,
+  ARDUINO_EVENT_WIFI_STA_LOST_IP,
+  ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+
+#define WIFI_REASON_ASSOC_LEAVE 8
+#define WIFI_REASON_BEACON_TIMEOUT 200
+#define WIFI_REASON_NO_AP_FOUND 201
+
+typedef struct {
+  uint8_t ssid[32];
+  uint8_t ssid_len;
+  uint8_t bssid[6];
+  uint8_t reason;
+} wifi_event_sta_disconnected_t;
+
+typedef union {
+  wifi_event_sta_disconnected_t wifi_sta_disconnected;
+} arduino_event_info_t;
+
+typedef void (*WiFiEventFuncCb)(arduino_event_id_t event, arduino_event_info_t info);
+typedef int wifi_event_id_t;
+
+// One simulated access point, "AgriLeafy-Sim", reachable while
+// hal::network().wifiUp. A join takes 1.5 s, or fails after 4 s without it.
+class WiFiClass {
+ public:
+  int status();
+  bool mode(int) { return true; }
+  int begin();   // saved credentials, returns at once
+  int begin(const char* ssid, const char* passphrase = nullptr);
+  String SSID();
+  String psk();
+  IPAddress localIP();
+  IPAddress gatewayIP() { return IPAddress(192, 168, 1, 1); }
+  IPAddress subnetMask() { return IPAddress(255, 255, 255, 0); }
+  int RSSI();
+  bool reconnect();
+  bool disconnect(bool = false);
+  bool setSleep(bool) { return true; }
+  bool setAutoReconnect(bool on);
+  bool getAutoReconnect();
+  void persistent(bool) {}
+  wifi_event_id_t onEvent(WiFiEventFuncCb callback, arduino_event_id_t event = ARDUINO_EVENT_MAX);
+  bool config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress(), IPAddress = IPAddress()) { return true; }
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,16 @@
+#pragma once
+#include <WiFi.h>
+class WiFiManager {
+ public:
+  void setConnectTimeout(int seconds) { connectTimeout_ = seconds; }
+  void setConfigPortalTimeout(int seconds) { portalTimeout_ = seconds; }
+  void setDebugOutput(bool) {}
+  bool autoConnect(const char* apName, const char* apPassword);
+  void setConfigPortalBlocking(bool blocking) { blocking_ = blocking; }
+  bool startConfigPortal(const char* apName, const char* apPassword);
+  bool process();
+  bool stopConfigPortal() { portalOpen_ = false; return true; }
+  void resetSettings() {}
+  int connectTimeout_ = 0, portalTimeout_ = 0;
+  bool blocking_ = true, portalOpen_ = false;
+};
@@ -0,0 +1,71 @@
+#pragma once
+// ADC continuous (DMA) mode, ESP-IDF 4.4 API, ESP32 flavour: ADC1 only,
+// TYPE1 output words. Conversions accumulate in a driver ring from
+// adc_digi_start(); the level comes from hal::devices().analog once per
+// 64 conversions with ADC noise added per conversion, like the real
+// converter's ±2 % scatter and rare spikes.
+#include <cstdint>
+typedef int esp_err_t;
+#ifndef ESP_OK
+#define ESP_OK 0
+#endif
+#ifndef ESP_FAIL
+#define ESP_FAIL -1
+#endif
+#ifndef ESP_ERR_INVALID_STATE
+#define ESP_ERR_INVALID_STATE 0x103
+#endif
+#ifndef ESP_ERR_TIMEOUT
+#define ESP_ERR_TIMEOUT 0x107
+#endif
+#ifndef BIT
+#define BIT(n) (1UL << (n))
+#endif
+#define SOC_ADC_DIGI_MAX_BITWIDTH 12
+#define ADC_MAX_DELAY UINT32_MAX
+
+typedef enum { ADC1_CHANNEL_0 = 0, ADC1_CHANNEL_3 = 3, ADC1_CHANNEL_6 = 6, ADC1_CHANNEL_7 = 7 } adc1_channel_t;
+typedef enum { ADC_ATTEN_DB_0 = 0, ADC_ATTEN_DB_11 = 3 } adc_atten_t;
+typedef enum { ADC_CONV_SINGLE_UNIT_1 = 1 } adc_digi_convert_mode_t;
+typedef enum { ADC_DIGI_OUTPUT_FORMAT_TYPE1 = 0 } adc_digi_output_format_t;
+
+typedef struct {
+  uint32_t max_store_buf_size;   // driver ring, bytes
+  uint32_t conv_num_each_intr;   // bytes per DMA interrupt
+  uint32_t adc1_chan_mask;
+  uint32_t adc2_chan_mask;
+} adc_digi_init_config_t;
+
+typedef struct {
+  uint8_t atten;
+  uint8_t channel;
+  uint8_t unit;
+  uint8_t bit_width;
+} adc_digi_pattern_config_t;
+
+typedef struct {
+  bool conv_limit_en;
+  uint32_t conv_limit_num;
+  uint32_t pattern_num;
+  adc_digi_pattern_config_t* adc_pattern;
+  uint32_t sample_freq_hz;
+  adc_digi_convert_mode_t conv_mode;
+  adc_digi_output_format_t format;
+} adc_digi_configuration_t;
+
+typedef struct {
+  union {
+    struct {
+      uint16_t data : 12;
+      uint16_t channel : 4;
+    } type1;
+    uint16_t val;
+  };
+} adc_digi_output_data_t;
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* init_config);
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config);
+esp_err_t adc_digi_start();
+esp_err_t adc_digi_stop();
+esp_err_t adc_digi_read_bytes(uint8_t* buf, uint32_t length_max, uint32_t* out_length, uint32_t timeout_ms);
+esp_err_t adc_digi_deinitialize();
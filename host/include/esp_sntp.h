@@ -0,0 +1,7 @@
+#pragma once
+// SNTP sync notification. The simulated SNTP client answers a round trip
+// after configTime() while WiFi is up and again every hour, like lwIP's
+// default CONFIG_LWIP_SNTP_UPDATE_DELAY.
+#include <sys/time.h>
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
@@ -0,0 +1,9 @@
+#pragma once
+// Task watchdog on the virtual clock: once a task is added, advancing time
+// past the timeout without esp_task_wdt_reset() aborts the run, as the
+// panicking watchdog resets the board. One watched task (single-task mode).
+typedef int esp_err_t;
+esp_err_t esp_task_wdt_init(int timeoutSeconds, bool panic);
+esp_err_t esp_task_wdt_add(void* task);
+esp_err_t esp_task_wdt_reset();
+esp_err_t esp_task_wdt_delete(void* task);
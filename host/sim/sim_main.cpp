@@ -0,0 +1,429 @@
+// Runs the unmodified firmware (src/main.cpp) against a simulated greenhouse
+// on the virtual clock: a month of sampling, auto-control, app commands and
+// network outages completes in seconds.
+//
+//   agri_leafy_sim [--days N] [--verbose]
+//
+// --verbose echoes the firmware's Serial output; otherwise one line per
+// simulated day and a summary are printed. Exits non-zero if nothing was
+// published or if loop() allocated from the heap after warm-up.
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "hal.h"
+
+void setup();
+void loop();
+
+namespace {
+
+// ====== DEVICE WIRING (mirrors src/main.cpp) ======
+const char* DEVICE_PATH = "/devices/ESP32_ALS_001";
+const uint8_t SOIL_PIN = 34;
+const uint8_t WATER_TRIG_PIN = 32;
+const uint8_t WATER_ECHO_PIN = 35;
+const uint8_t PUMP_IRRIGATION_PIN = 26;
+const uint8_t PUMP_MISTING_PIN = 27;
+const uint8_t SHADE_DEPLOY_PIN = 14;
+const uint8_t SHADE_RETRACT_PIN = 33;
+const int XYMD02_UART = 2;
+const int NPK_UART = 1;
+const double TANK_HEIGHT_CM = 45;
+
+const time_t START_EPOCH = 1748707200;   // 2025-06-01 00:00 PHT (UTC+8)
+const long PH_OFFSET_SEC = 8 * 3600;
+const uint64_t US_PER_S = 1000000ULL;
+const uint64_t US_PER_DAY = 86400ULL * US_PER_S;
+// After each boot, loop() may still allocate once (first publish, first
+// perf window); from then on it must not touch the heap.
+const uint64_t WARMUP_US = 10 * 60 * US_PER_S;
+
+// ====== NOISE ======
+uint32_t noiseState = 12345;
+double noise(double amplitude) {
+  double sum = 0;
+  for (int i = 0; i < 3; i++) {
+    noiseState = noiseState * 1664525u + 1013904223u;
+    sum += (noiseState >> 8) / 16777216.0;
+  }
+  return (sum - 1.5) * amplitude;
+}
+
+// ====== GREENHOUSE MODEL ======
+struct Greenhouse {
+  double soil = 62;          // % volumetric
+  double tankCm = 40;        // water above the tank floor
+  double mistBoost = 0;      // % RH added by recent misting
+  double cloud = 1.0;        // today's light factor
+  double nitrogen = 120, phosphorus = 45, potassium = 160;
+  bool shade = false;
+  bool xymd02Online = true;
+  uint64_t lastUs = 0;
+
+  // Day statistics
+  double soilMin = 100, soilMax = 0;
+  uint64_t irrigationUs = 0, mistingUs = 0;
+
+  double localHour() const {
+    uint64_t local = (uint64_t)(START_EPOCH + PH_OFFSET_SEC) * US_PER_S + hal::nowUs();
+    return (double)(local % US_PER_DAY) / (3600.0 * US_PER_S);
+  }
+  bool daylight() const { double h = localHour(); return h >= 6 && h < 18; }
+
+  void advance() {
+    uint64_t now = hal::nowUs();
+    if (now <= lastUs) return;
+    double dt = (now - lastUs) / (double)US_PER_S;
+    lastUs = now;
+
+    bool irrigating = hal::pinLevel(PUMP_IRRIGATION_PIN);
+    bool misting = hal::pinLevel(PUMP_MISTING_PIN);
+    if (irrigating) {
+      soil += 0.4 * dt;
+      tankCm -= 0.03 * dt;
+      irrigationUs += (uint64_t)(dt * US_PER_S);
+    }
+    if (misting) {
+      mistBoost += 0.5 * dt;
+      tankCm -= 0.01 * dt;
+      mistingUs += (uint64_t)(dt * US_PER_S);
+    }
+    double dryingPerHour = daylight() ? (shade ? 0.8 : 1.3) : 0.3;
+    soil -= dryingPerHour * dt / 3600.0;
+    mistBoost *= exp(-dt / 600.0);
+    soil = std::min(95.0, std::max(5.0, soil));
+    tankCm = std::max(0.0, tankCm);
+    mistBoost = std::min(15.0, mistBoost);
+    nitrogen -= 0.5 * dt / 86400.0;
+    soilMin = std::min(soilMin, soil);
+    soilMax = std::max(soilMax, soil);
+  }
+
+  double diurnal() const { return sin(2 * M_PI * (localHour() - 9) / 24.0); }
+
+  double airTemperature() const { return 27 + 6 * diurnal() - (shade ? 2 : 0); }
+  double temperature() { advance(); return airTemperature() + noise(0.3); }
+
+  double humidity() {
+    advance();
+    return std::min(99.0, std::max(30.0, 76 - 14 * diurnal() + mistBoost + noise(1.0)));
+  }
+
+  float lux() {
+    advance();
+    if (!daylight()) return 0;
+    double sun = sin(M_PI * (localHour() - 6) / 12.0);
+    return (float)std::max(0.0, 2600 * sun * cloud * (shade ? 0.45 : 1.0) + noise(15));
+  }
+
+  uint16_t soilRaw() {
+    advance();
+    return (uint16_t)std::max(0.0, 3000 - soil / 100.0 * 1700 + noise(12));
+  }
+
+  // Sound speed follows the air temperature; while a pump runs the ripples
+  // return about one ping in four off a wave crest or trough
+  unsigned long echoUs() {
+    advance();
+    double distance = TANK_HEIGHT_CM - tankCm + noise(0.3);
+    if ((hal::pinLevel(PUMP_IRRIGATION_PIN) || hal::pinLevel(PUMP_MISTING_PIN)) && noise(1.0) > 0.3) {
+      distance += noise(16.0);
+    }
+    double cmPerUs = (331.3 + 0.606 * airTemperature()) / 10000.0;
+    return (unsigned long)(std::max(2.0, distance) * 2 / cmPerUs);
+  }
+};
+
+Greenhouse house;
+
+// ====== ACTUATOR ON-TIMES ======
+// Outputs the firmware switches off on a timer: how far past its nominal
+// on-time each one ran, measured at the pin. Shorter runs are manual stops.
+struct OutputWatch {
+  uint8_t pin;
+  uint64_t nominalUs;
+  uint64_t onUs;
+  unsigned runs;
+  int64_t worstOverrunUs;
+};
+
+OutputWatch outputs[] = {
+  {PUMP_IRRIGATION_PIN, 30 * US_PER_S, 0, 0, 0},
+  {PUMP_MISTING_PIN, 15 * US_PER_S, 0, 0, 0},
+  {SHADE_DEPLOY_PIN, 10 * US_PER_S, 0, 0, 0},
+  {SHADE_RETRACT_PIN, 10 * US_PER_S, 0, 0, 0},
+};
+
+void watchOutput(uint8_t pin, uint8_t level) {
+  for (OutputWatch& out : outputs) {
+    if (out.pin != pin) continue;
+    if (level) {
+      out.onUs = hal::nowUs();
+      continue;
+    }
+    out.runs++;
+    out.worstOverrunUs = std::max(out.worstOverrunUs, (int64_t)(hal::nowUs() - out.onUs - out.nominalUs));
+  }
+}
+
+void wireDevices() {
+  hal::Devices& dev = hal::devices();
+  dev.analog = [](uint8_t pin) -> uint16_t { return pin == SOIL_PIN ? house.soilRaw() : 0; };
+  dev.echoUs = [](uint8_t pin) -> unsigned long { return pin == WATER_ECHO_PIN ? house.echoUs() : 0; };
+  dev.echoTrigPin = WATER_TRIG_PIN;
+  dev.echoPin = WATER_ECHO_PIN;
+  dev.lux = []() { return house.lux(); };
+  dev.holdingRegisters = [](int uart, uint16_t address, uint16_t count, uint16_t* out) {
+    if (uart == XYMD02_UART && address == 0x0000 && count == 2) {
+      if (!house.xymd02Online) return false;
+      out[0] = (uint16_t)lround(house.humidity() * 10);
+      out[1] = (uint16_t)lround(house.temperature() * 10);
+      return true;
+    }
+    if (uart == NPK_UART && address == 0x001E && count == 3) {
+      out[0] = (uint16_t)lround(house.nitrogen + noise(2));
+      out[1] = (uint16_t)lround(house.phosphorus + noise(1));
+      out[2] = (uint16_t)lround(house.potassium + noise(2));
+      return true;
+    }
+    return false;
+  };
+  dev.pinChanged = [](uint8_t pin, uint8_t level) {
+    house.advance();
+    watchOutput(pin, level);
+    if (pin == SHADE_DEPLOY_PIN && level) house.shade = true;
+    if (pin == SHADE_RETRACT_PIN && level) house.shade = false;
+  };
+}
+
+// ====== SCENARIO ======
+struct Event {
+  uint64_t atUs;
+  const char* label;
+  std::function<void()> run;
+};
+
+std::vector<Event> events;
+
+// Day d (0-based) at local hour h; the run starts at local midnight
+uint64_t at(int day, double hour) {
+  return (uint64_t)day * US_PER_DAY + (uint64_t)(hour * 3600.0 * US_PER_S);
+}
+
+void app(const std::string& key, const std::string& json) {
+  hal::rtdbPut(std::string(DEVICE_PATH) + "/" + key, json);
+}
+
+void seedDatabase() {
+  app("plant_settings",
+      "{\"selected_plant\":\"Pechay\",\"min_temperature\":18.0,\"max_temperature\":30.0,"
+      "\"min_soil_moisture\":40,\"max_soil_moisture\":80,\"min_humidity\":60,\"max_humidity\":85,"
+      "\"min_light_intensity\":800,\"max_light_intensity\":1500}");
+}
+
+void buildScenario(int days) {
+  for (int d = 0; d < days; d++) {
+    events.push_back({at(d, 6), nullptr, [] { house.tankCm = 40; house.cloud = 0.8 + noise(0.25); }});
+  }
+
+  events.push_back({at(1, 8), "app: manual mode, misting", [] {
+    app("commands/mode", "\"manual\"");
+    app("commands/pump_command", "\"misting_start\"");
+  }});
+  events.push_back({at(1, 8.05), "app: auto mode", [] { app("commands/mode", "\"auto\""); }});
+
+  for (int d = 3; d < days; d += 7) {
+    events.push_back({at(d, 13), "WiFi down", [] { hal::network().wifiUp = false; }});
+    events.push_back({at(d, 15), "WiFi up", [] { hal::network().wifiUp = true; }});
+  }
+  for (int d = 5; d < days; d += 7) {
+    events.push_back({at(d, 2), "Firebase unreachable", [] {
+      hal::network().backendUp = false;
+      hal::network().failureCostMs = 3000;
+    }});
+    events.push_back({at(d, 2.75), "Firebase back", [] {
+      hal::network().backendUp = true;
+      hal::network().failureCostMs = 0;
+    }});
+  }
+  // Every RTDB call hangs for 30 s right after a pump start: the cut-off
+  // must not wait for the loop to come back
+  if (days > 8) {
+    events.push_back({at(8, 12), "app: manual mode, misting", [] {
+      app("commands/mode", "\"manual\"");
+      app("commands/pump_command", "\"misting_start\"");
+    }});
+    events.push_back({at(8, 12) + 2 * US_PER_S, "Firebase stalls 30 s per call", [] {
+      hal::network().backendUp = false;
+      hal::network().failureCostMs = 30000;
+    }});
+    events.push_back({at(8, 12.25), "Firebase back, app: auto mode", [] {
+      hal::network().backendUp = true;
+      hal::network().failureCostMs = 0;
+      app("commands/mode", "\"auto\"");
+    }});
+  }
+  if (days > 11) {
+    events.push_back({at(11, 9), "app: plant changed to Lettuce", [] {
+      app("plant_settings",
+          "{\"selected_plant\":\"Lettuce\",\"min_temperature\":15.0,\"max_temperature\":24.0,"
+          "\"min_soil_moisture\":50,\"max_soil_moisture\":85,\"min_humidity\":55,\"max_humidity\":80,"
+          "\"min_light_intensity\":600,\"max_light_intensity\":1200}");
+      app("commands/plant_changed", "true");
+    }});
+  }
+  if (days > 20) {
+    events.push_back({at(20, 0), "XYMD02 unplugged", [] { house.xymd02Online = false; }});
+    events.push_back({at(20, 1), "XYMD02 back", [] { house.xymd02Online = true; }});
+  }
+
+  std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.atUs < b.atUs; });
+}
+
+// ====== REPORTING ======
+struct DayMark {
+  hal::RtdbStats rtdb;
+  unsigned restarts;
+};
+
+void printDay(int day, const DayMark& start) {
+  const hal::RtdbStats& now = hal::rtdbStats();
+  printf("day %2d | requests %6llu (failed %5llu) | up %7.1f KB, down %7.1f KB, %3llu TLS | irrigation %4llu s, misting %4llu s | soil %4.1f-%4.1f %% | restarts %u\n",
+         day + 1,
+         (unsigned long long)(now.requests - start.rtdb.requests),
+         (unsigned long long)(now.failures - start.rtdb.failures),
+         (now.bytesUp - start.rtdb.bytesUp) / 1024.0,
+         (now.bytesDown - start.rtdb.bytesDown) / 1024.0,
+         (unsigned long long)(now.handshakes - start.rtdb.handshakes),
+         (unsigned long long)(house.irrigationUs / US_PER_S),
+         (unsigned long long)(house.mistingUs / US_PER_S),
+         house.soilMin, house.soilMax,
+         hal::restartCount() - start.restarts);
+  house.soilMin = 100;
+  house.soilMax = 0;
+  house.irrigationUs = 0;
+  house.mistingUs = 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int days = 30;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--days") && i + 1 < argc) days = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--verbose")) hal::setSerialEcho(true);
+    else {
+      fprintf(stderr, "usage: %s [--days N] [--verbose]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  hal::setWallClock(START_EPOCH);
+  wireDevices();
+  seedDatabase();
+  buildScenario(days);
+
+  auto wallStart = std::chrono::steady_clock::now();
+  uint64_t endUs = (uint64_t)days * US_PER_DAY;
+  size_t nextEvent = 0;
+  hal::setNextEventSource([&nextEvent] {
+    return nextEvent < events.size() ? events[nextEvent].atUs : UINT64_MAX;
+  });
+  int day = 0;
+  DayMark mark = {hal::rtdbStats(), 0};
+  bool booting = true;
+  uint64_t bootUs = 0;
+
+  while (hal::nowUs() < endUs) {
+    // ESP.restart() unwinds to here; RAM is not reset, flash and RTDB persist
+    try {
+      if (booting) {
+        booting = false;
+        setup();
+        bootUs = hal::nowUs();
+      } else {
+        hal::setAllocAudit(hal::nowUs() - bootUs >= WARMUP_US);
+        loop();
+      }
+    } catch (const hal::Restart&) {
+      booting = true;
+    }
+    hal::setAllocAudit(false);
+
+    while (nextEvent < events.size() && events[nextEvent].atUs <= hal::nowUs()) {
+      if (events[nextEvent].label) printf("       %s\n", events[nextEvent].label);
+      events[nextEvent].run();
+      nextEvent++;
+    }
+
+    if (hal::nowUs() >= (uint64_t)(day + 1) * US_PER_DAY) {
+      house.advance();
+      printDay(day, mark);
+      mark = {hal::rtdbStats(), hal::restartCount()};
+      day++;
+    }
+  }
+
+  double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  const hal::RtdbStats& rtdb = hal::rtdbStats();
+  std::string timestamp;
+  bool online = hal::rtdbGet(std::string(DEVICE_PATH) + "/status/timestamp", timestamp);
+  size_t sensorLeaves = hal::rtdbCount(std::string(DEVICE_PATH) + "/sensor_data");
+  std::string awake;
+  bool haveAwake = hal::rtdbGet(std::string(DEVICE_PATH) + "/status/awake_pct", awake);
+  std::string soilNoise;
+  bool haveNoise = hal::rtdbGet(std::string(DEVICE_PATH) + "/status/soil_noise_lsb", soilNoise);
+  std::string bootControl, bootPublish;
+  bool haveBoot = hal::rtdbGet(std::string(DEVICE_PATH) + "/status/boot/decision_ms", bootControl) &&
+                  hal::rtdbGet(std::string(DEVICE_PATH) + "/status/boot/publish_ms", bootPublish);
+
+  printf("\n=== %d simulated days in %.1f s (%.0fx) ===\n", days, wallSec, days * 86400.0 / std::max(wallSec, 1e-6));
+  printf("RTDB: %llu requests (%.0f/day), %llu failed, %.1f KB/day up, %llu stream events\n",
+         (unsigned long long)rtdb.requests, rtdb.requests / (double)days,
+         (unsigned long long)rtdb.failures, rtdb.bytesUp / 1024.0 / days,
+         (unsigned long long)rtdb.streamEvents);
+  printf("RTDB: %.1f KB/day down, %llu TLS handshakes (%.1f KB/day)\n", rtdb.bytesDown / 1024.0 / days,
+         (unsigned long long)rtdb.handshakes, rtdb.handshakeBytes / 1024.0 / days);
+  printf("RTDB: %zu sensor_data leaves, %zu backfilled samples, status/timestamp %s\n",
+         sensorLeaves, hal::rtdbCount(std::string(DEVICE_PATH) + "/history/samples"),
+         online ? timestamp.c_str() : "missing");
+  printf("RTDB: %zu minute and %zu hour rollups\n",
+         hal::rtdbChildren(std::string(DEVICE_PATH) + "/history/minute"),
+         hal::rtdbChildren(std::string(DEVICE_PATH) + "/history/hour"));
+  printf("Flash: %.1f KB used, %zu history blocks, %zu backlog segments\n",
+         hal::fsUsedBytes() / 1024.0, hal::fsFileCount("/history/"), hal::fsFileCount("/backlog/"));
+  printf("Device: %u restarts, %.1f MB serial output, awake %s %%, soil ADC noise %s LSB\n",
+         hal::restartCount(), hal::serialBytes() / 1048576.0, haveAwake ? awake.c_str() : "?",
+         haveNoise ? soilNoise.c_str() : "?");
+  printf("Last boot: first control decision at %s ms, first publish at %s ms\n",
+         haveBoot ? bootControl.c_str() : "?", haveBoot ? bootPublish.c_str() : "?");
+  std::string outages, outageSec, outageJoins;
+  bool haveWiFi = hal::rtdbGet(std::string(DEVICE_PATH) + "/status/wifi/outages", outages) &&
+                  hal::rtdbGet(std::string(DEVICE_PATH) + "/status/wifi/last_outage_s", outageSec) &&
+                  hal::rtdbGet(std::string(DEVICE_PATH) + "/status/wifi/last_join_attempts", outageJoins);
+  printf("WiFi: %s outages reported, last one %s s over %s join attempts\n", haveWiFi ? outages.c_str() : "no",
+         haveWiFi ? outageSec.c_str() : "?", haveWiFi ? outageJoins.c_str() : "?");
+  std::string trips, openSec, updatesRejected;
+  bool haveBreaker = hal::rtdbGet(std::string(DEVICE_PATH) + "/status/rtdb/trips", trips) &&
+                     hal::rtdbGet(std::string(DEVICE_PATH) + "/status/rtdb/last_open_s", openSec) &&
+                     hal::rtdbGet(std::string(DEVICE_PATH) + "/status/rtdb/update/rejected", updatesRejected);
+  printf("Breaker: %s trips reported, last open %s s, %s updates held back\n", haveBreaker ? trips.c_str() : "no",
+         haveBreaker ? openSec.c_str() : "?", haveBreaker ? updatesRejected.c_str() : "?");
+  std::string handshakes, handshakeMs, perCycleUp, perCycleDown;
+  bool haveTls = hal::rtdbGet(std::string(DEVICE_PATH) + "/status/rtdb/handshakes", handshakes) &&
+                 hal::rtdbGet(std::string(DEVICE_PATH) + "/status/rtdb/handshake_max_ms", handshakeMs) &&
+                 hal::rtdbGet(std::string(DEVICE_PATH) + "/status/rtdb/payload_bytes_up_per_cycle", perCycleUp) &&
+                 hal::rtdbGet(std::string(DEVICE_PATH) + "/status/rtdb/payload_bytes_down_per_cycle", perCycleDown);
+  printf("TLS: %s handshakes reported (max %s ms), %s B up and %s B down of payload per cycle\n",
+         haveTls ? handshakes.c_str() : "no", haveTls ? handshakeMs.c_str() : "?", haveTls ? perCycleUp.c_str() : "?",
+         haveTls ? perCycleDown.c_str() : "?");
+  printf("Actuators: worst run past the cut-off: pump %lld us over %u runs, shade %lld us over %u moves\n",
+         (long long)std::max(outputs[0].worstOverrunUs, outputs[1].worstOverrunUs), outputs[0].runs + outputs[1].runs,
+         (long long)std::max(outputs[2].worstOverrunUs, outputs[3].worstOverrunUs), outputs[2].runs + outputs[3].runs);
+  hal::AllocStats heap = hal::allocStats();
+  printf("Heap: %llu allocations (%llu bytes) in loop() after warm-up\n",
+         (unsigned long long)heap.allocations, (unsigned long long)heap.bytes);
+
+  return (sensorLeaves > 0 && online && heap.allocations == 0) ? 0 : 1;
+}
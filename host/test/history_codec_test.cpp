@@ -0,0 +1,144 @@
+// Round-trips the firmware's history codec (TimeSeriesEncoder/Decoder in
+// src/main.cpp) over a synthetic month of greenhouse samples and reports
+// the compression and host throughput.
+//
+//   agri_history_codec_test [--samples N]
+//
+// Exits non-zero if any decoded sample differs from what was encoded, or
+// if an open block replayed into a fresh encoder (the boot-time restore of
+// HISTORY_OPEN_PATH) does not serialize to the same bytes.
+#include "main.cpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct Sample {
+  uint32_t epoch;
+  int32_t values[HC_COUNT];
+};
+
+uint32_t rng = 2024;
+uint32_t nextRandom() {
+  rng = rng * 1664525u + 1013904223u;
+  return rng >> 8;
+}
+int32_t jitter(int32_t amplitude) { return (int32_t)(nextRandom() % (2 * amplitude + 1)) - amplitude; }
+
+// Same fixed-point scales as sensorChannels: temperature ×10, the rest whole units
+std::vector<Sample> makeSamples(size_t count) {
+  std::vector<Sample> samples(count);
+  uint32_t epoch = 1748707200;
+  double soil = 62;
+  for (size_t i = 0; i < count; i++) {
+    Sample& s = samples[i];
+    // Mostly 60 s apart, 5 s bursts while values move, rare late samples
+    uint32_t r = nextRandom() % 100;
+    epoch += r < 10 ? 5 : (r < 98 ? 60 : 60 + nextRandom() % 30);
+    s.epoch = epoch;
+
+    double hour = (epoch % 86400) / 3600.0;
+    double day = sin((hour - 9) * M_PI / 12);
+    soil -= 0.002;
+    if (soil < 50) soil = 62;
+
+    s.values[HC_TEMPERATURE_X10] = (int32_t)lround(270 + 60 * day) + jitter(2);
+    s.values[HC_HUMIDITY] = (int32_t)lround(70 - 15 * day) + jitter(1);
+    s.values[HC_SOIL] = (int32_t)lround(soil);
+    s.values[HC_LIGHT] = hour >= 6 && hour < 18 ? (int32_t)lround(30000 * sin((hour - 6) * M_PI / 12)) + jitter(200) : 0;
+    s.values[HC_NITROGEN] = 120 + jitter(1);
+    s.values[HC_PHOSPHORUS] = 45;
+    s.values[HC_POTASSIUM] = 160 + jitter(1);
+    s.values[HC_WATER_PERCENT] = (int32_t)(88 - (i / 500) % 40);
+    if (nextRandom() % 1000 == 0) s.values[HC_SOIL] = HISTORY_NO_VALUE;   // probe dropout
+  }
+  return samples;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+TimeSeriesEncoder encoder;
+TimeSeriesEncoder replayed;
+uint8_t block[HISTORY_BLOCK_BYTES];
+uint8_t replayBlock[HISTORY_BLOCK_BYTES];
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t count = 200000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--samples") && i + 1 < argc) count = strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr, "usage: %s [--samples N]\n", argv[0]);
+      return 2;
+    }
+  }
+  std::vector<Sample> samples = makeSamples(count);
+
+  // Encode into sealed blocks exactly as historyAppend()/sealHistoryBlock() do
+  std::vector<std::vector<uint8_t>> blocks;
+  auto start = std::chrono::steady_clock::now();
+  encoder.begin();
+  for (const Sample& s : samples) {
+    if (!encoder.append(s.epoch, s.values)) {
+      size_t len = encoder.finish(block, sizeof(block));
+      blocks.emplace_back(block, block + len);
+      encoder.begin();
+      encoder.append(s.epoch, s.values);
+    }
+  }
+  size_t len = encoder.finish(block, sizeof(block));
+  blocks.emplace_back(block, block + len);
+  double encodeS = secondsSince(start);
+
+  // Restoring the open block must rebuild the encoder state bit for bit
+  TimeSeriesDecoder decoder;
+  replayed.begin();
+  uint32_t epoch;
+  int32_t values[HC_COUNT];
+  if (decoder.begin(block, len)) {
+    while (decoder.next(epoch, values)) replayed.append(epoch, values);
+  }
+  size_t replayLen = replayed.finish(replayBlock, sizeof(replayBlock));
+  bool replayOk = replayLen == len && memcmp(replayBlock, block, len) == 0;
+
+  size_t decoded = 0, mismatches = 0, bytes = 0;
+  start = std::chrono::steady_clock::now();
+  for (const std::vector<uint8_t>& b : blocks) {
+    bytes += b.size();
+    if (!decoder.begin(b.data(), b.size())) {
+      mismatches++;
+      continue;
+    }
+    while (decoder.next(epoch, values)) {
+      if (decoded < count) {
+        const Sample& s = samples[decoded];
+        if (epoch != s.epoch || memcmp(values, s.values, sizeof(values)) != 0) mismatches++;
+      }
+      decoded++;
+    }
+  }
+  double decodeS = secondsSince(start);
+
+  const double rawBytes = sizeof(uint32_t) + sizeof(int32_t) * HC_COUNT;
+  printf("History codec: %zu samples in %zu blocks, %zu bytes\n", count, blocks.size(), bytes);
+  printf("  %.2f B/sample (raw %.0f B, %.1fx), %.0f samples/block\n", (double)bytes / count, rawBytes,
+         rawBytes * count / bytes, (double)count / blocks.size());
+  printf("  encode %.2f M samples/s, decode %.2f M samples/s\n", count / encodeS / 1e6, decoded / decodeS / 1e6);
+
+  if (decoded != count || mismatches > 0) {
+    printf("FAIL: %zu of %zu samples decoded, %zu mismatches\n", decoded, count, mismatches);
+    return 1;
+  }
+  if (!replayOk) {
+    printf("FAIL: replayed open block differs (%zu vs %zu bytes)\n", replayLen, len);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
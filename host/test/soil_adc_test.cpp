@@ -0,0 +1,107 @@
+// Feeds known noise and spikes through the firmware's SoilAdc (src/main.cpp)
+// via the simulated ADC DMA driver, checks that the burst median and the
+// noise estimate stay within bounds, then times collect().
+//
+//   agri_soil_adc_test [--bursts N]
+//
+// Exits non-zero if any case is out of bounds.
+#include "main.cpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "hal.h"
+
+namespace {
+
+const uint16_t LEVEL = 2000;   // LSB the probe reads between conversions
+
+struct Case {
+  const char* name;
+  std::function<int(uint64_t n)> noise;
+  float medianTolerance;   // |burstRaw() - LEVEL|
+  float noiseMin, noiseMax;
+};
+
+// Deterministic ±30 LSB uniform noise: σ = 60 / √12 ≈ 17.3
+int uniform30(uint64_t n) {
+  uint32_t x = (uint32_t)n * 2654435761u;
+  x ^= x >> 15;
+  return (int)(x % 61) - 30;
+}
+
+SoilAdc adc;
+
+float runBurst() {
+  adc.startBurst();
+  hal::advanceUs((uint64_t)SOIL_ADC_BURST_MS * 1000);
+  adc.collect();
+  return adc.burstRaw();
+}
+
+bool check(const Case& c) {
+  hal::devices().adcNoise = c.noise;
+  float burst = runBurst();
+  float noise = adc.noiseLsb();
+  bool ok = !isnan(burst) && fabsf(burst - LEVEL) <= c.medianTolerance &&
+            noise >= c.noiseMin && noise <= c.noiseMax;
+  printf("  %-28s median %7.1f  noise %6.1f LSB  %s\n", c.name, burst, noise, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int bursts = 2000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--bursts") && i + 1 < argc) bursts = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [--bursts N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  hal::devices().analog = [](uint8_t pin) -> uint16_t { return pin == SOIL_PIN ? LEVEL : 0; };
+  adc.begin(SOIL_ADC_CHANNEL);
+  if (!adc.ok()) {
+    printf("FAIL: ADC did not start\n");
+    return 1;
+  }
+
+  const Case cases[] = {
+    {"clean", [](uint64_t) { return 0; }, 0, 0, 0},
+    {"uniform +-30", uniform30, 4, 15, 20},
+    // A few isolated spikes only move the blocks they land in
+    {"noise + 3 spikes", [](uint64_t n) { return uniform30(n) + (n % 300 == 150 ? 1500 : 0); }, 4, 15, 120},
+    // A 64-conversion glitch (pump relay) fills one block; the median drops it
+    {"noise + relay glitch", [](uint64_t n) { return uniform30(n) + (n >= 512 && n < 576 ? -1800 : 0); }, 4, 300, 500},
+    // Glitches in three blocks of sixteen still leave the median clean
+    {"noise + 3 glitch blocks", [](uint64_t n) { return uniform30(n) + ((n / 64) % 5 == 2 ? 1000 : 0); }, 6, 350, 500},
+  };
+
+  printf("SoilAdc at %u LSB, %u conversions per burst:\n", LEVEL, SOIL_ADC_BURST);
+  bool ok = true;
+  for (const Case& c : cases) ok = check(c) && ok;
+
+  // Unplugged probe: every conversion reads 0
+  hal::devices().adcNoise = nullptr;
+  hal::devices().analog = [](uint8_t) -> uint16_t { return 0; };
+  bool unplugged = isnan(runBurst());
+  printf("  %-28s %s\n", "unplugged", unplugged ? "ok (NAN)" : "FAIL");
+  ok = ok && unplugged;
+
+  // collect() cost: drain, decimate and sort one burst (driver ring emulation included)
+  hal::devices().analog = [](uint8_t) -> uint16_t { return LEVEL; };
+  double collectS = 0;
+  for (int i = 0; i < bursts; i++) {
+    adc.startBurst();
+    hal::advanceUs((uint64_t)SOIL_ADC_BURST_MS * 1000);
+    auto start = std::chrono::steady_clock::now();
+    adc.collect();
+    collectS += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  printf("collect(): %.1f us per burst over %d bursts\n", collectS / bursts * 1e6, bursts);
+
+  printf(ok ? "OK\n" : "FAIL\n");
+  return ok ? 0 : 1;
+}